@@ -0,0 +1,239 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+#include <initializer_list>
+#include <string_parts.hpp>
+
+namespace my {
+
+template<typename CharT,
+         typename TraitsT = std::char_traits<CharT>>
+class aho_corasick{
+
+    static_assert(sizeof (CharT) == 1, "aho_corasick works over a byte alphabet");
+
+    using view_type = std::basic_string_view<CharT, TraitsT>;
+
+    static constexpr uint32_t none     = static_cast<uint32_t>(-1);
+    static constexpr uint32_t alphabet = 256;
+
+    std::vector<uint32_t> base_;
+    std::vector<uint32_t> check_;
+    std::vector<uint32_t> fail_;
+    std::vector<uint32_t> dict_;
+    std::vector<uint32_t> out_;
+    std::vector<uint32_t> ids_;
+    std::vector<size_t>   lengths_;
+
+    struct node{
+        std::vector<std::pair<uint32_t, uint32_t>> next;
+        std::vector<uint32_t> ids;
+    };
+
+    static uint32_t code(CharT c){
+        return static_cast<uint32_t>(static_cast<unsigned char>(c)) + 1;
+    }
+
+    uint32_t child(uint32_t state, uint32_t c) const{
+        uint32_t t = base_[state] + c;
+        if(base_[state] != 0 && t < check_.size() && check_[t] == state) return t;
+        return none;
+    }
+
+    uint32_t step(uint32_t state, uint32_t c) const{
+        while(true){
+            uint32_t t = child(state, c);
+            if(t != none) return t;
+            if(state == 0) return 0;
+            state = fail_[state];
+        }
+    }
+
+    void grow(size_t n){
+        if(n <= check_.size()) return;
+        base_.resize(n, 0);
+        check_.resize(n, none);
+    }
+
+    static uint32_t next_free(std::vector<uint32_t>& skip, uint32_t pos){
+        uint32_t root = pos;
+        while(root < skip.size() && skip[root] != root) root = skip[root];
+        while(pos < skip.size() && skip[pos] != pos){
+            uint32_t next = skip[pos];
+            skip[pos] = root;
+            pos = next;
+        }
+        return root;
+    }
+
+    static void take(std::vector<uint32_t>& skip, uint32_t pos){
+        skip[pos] = pos + 1;
+    }
+
+    uint32_t place(const std::vector<std::pair<uint32_t, uint32_t>>& next, std::vector<uint32_t>& skip){
+        const uint32_t low = next.front().first;
+        for(uint32_t f = next_free(skip, low + 1);; f = next_free(skip, f + 1)){
+            uint32_t b = f - low;
+            grow(b + alphabet + 1);
+            while(skip.size() < check_.size()) skip.push_back(static_cast<uint32_t>(skip.size()));
+            bool ok = true;
+            for(auto& edge : next){
+                if(check_[b + edge.first] != none){
+                    ok = false;
+                    break;
+                }
+            }
+            if(ok) return b;
+        }
+    }
+
+    void build(const std::vector<view_type>& patterns){
+        std::vector<node> trie(1);
+        for(size_t id = 0; id < patterns.size(); ++id){
+            if(patterns[id].empty()) throw std::invalid_argument("Empty pattern can never match");
+            lengths_.push_back(patterns[id].size());
+            uint32_t cur = 0;
+            for(CharT ch : patterns[id]){
+                uint32_t c = code(ch);
+                auto& next = trie[cur].next;
+                auto it = std::find_if(next.begin(), next.end(), [c](auto& e){ return e.first == c; });
+                if(it != next.end()){
+                    cur = it->second;
+                    continue;
+                }
+                next.emplace_back(c, static_cast<uint32_t>(trie.size()));
+                cur = static_cast<uint32_t>(trie.size());
+                trie.emplace_back();
+            }
+            trie[cur].ids.push_back(static_cast<uint32_t>(id));
+        }
+
+        grow(alphabet + 1);
+        check_[0] = 0;
+        std::vector<uint32_t> skip(check_.size());
+        for(uint32_t i = 0; i < skip.size(); ++i) skip[i] = i;
+        take(skip, 0);
+        std::vector<uint32_t> position(trie.size(), 0);
+        std::vector<uint32_t> order{0};
+        for(size_t i = 0; i < order.size(); ++i){
+            node& n = trie[order[i]];
+            if(n.next.empty()) continue;
+            std::sort(n.next.begin(), n.next.end());
+            uint32_t p = position[order[i]];
+            uint32_t b = place(n.next, skip);
+            base_[p] = b;
+            for(auto& edge : n.next){
+                check_[b + edge.first] = p;
+                take(skip, b + edge.first);
+                position[edge.second] = b + edge.first;
+                order.push_back(edge.second);
+            }
+        }
+
+        size_t states = check_.size();
+        while(states > 1 && check_[states - 1] == none) states--;
+        base_.resize(states);
+        check_.resize(states);
+        base_.shrink_to_fit();
+        check_.shrink_to_fit();
+
+        fail_.assign(states, 0);
+        dict_.assign(states, none);
+        out_.assign(states + 1, 0);
+        for(uint32_t trie_idx : order){
+            uint32_t p = position[trie_idx];
+            out_[p + 1] = static_cast<uint32_t>(trie[trie_idx].ids.size());
+        }
+        for(size_t i = 0; i < states; ++i) out_[i + 1] += out_[i];
+        ids_.resize(out_[states]);
+        for(uint32_t trie_idx : order){
+            uint32_t p = position[trie_idx];
+            std::copy(trie[trie_idx].ids.begin(), trie[trie_idx].ids.end(), ids_.begin() + out_[p]);
+        }
+
+        for(uint32_t parent_idx : order){
+            uint32_t parent = position[parent_idx];
+            for(auto& edge : trie[parent_idx].next){
+                uint32_t target = position[edge.second];
+                uint32_t f = parent == 0 ? 0 : step(fail_[parent], edge.first);
+                fail_[target] = f;
+                dict_[target] = out_[f + 1] != out_[f] ? f : dict_[f];
+            }
+        }
+    }
+
+public:
+
+    struct match{
+        size_t pattern;
+        size_t pos;
+    };
+
+    aho_corasick(std::initializer_list<view_type> patterns){
+        build(std::vector<view_type>(patterns));
+    }
+
+    template<typename InputIt>
+    aho_corasick(InputIt beg, InputIt end){
+        std::vector<view_type> patterns;
+        for(; beg != end; ++beg) patterns.push_back(as_view<view_type>(*beg));
+        build(patterns);
+    }
+
+    size_t size() const{
+        return lengths_.size();
+    }
+
+    size_t states() const{
+        return fail_.size();
+    }
+
+    size_t bytes() const{
+        return (base_.size() + check_.size() + fail_.size() + dict_.size() + out_.size() + ids_.size()) * sizeof (uint32_t)
+             + lengths_.size() * sizeof (size_t);
+    }
+
+    template<typename F>
+    void scan(view_type text, F&& callback) const{
+        uint32_t state = 0;
+        for(size_t i = 0; i < text.size(); ++i){
+            state = step(state, code(text[i]));
+            uint32_t out = out_[state + 1] != out_[state] ? state : dict_[state];
+            for(; out != none; out = dict_[out])
+                for(uint32_t k = out_[out]; k < out_[out + 1]; ++k)
+                    callback(static_cast<size_t>(ids_[k]), i + 1 - lengths_[ids_[k]]);
+        }
+    }
+
+    template<typename StringT,
+             typename F,
+             std::enable_if_t<!std::is_convertible_v<const StringT&, view_type>, int> = 0>
+    void scan(const StringT& str, F&& callback) const{
+        scan(as_view<view_type>(str), std::forward<F>(callback));
+    }
+
+    template<typename StringT>
+    std::vector<match> find_all(const StringT& str) const{
+        std::vector<match> res;
+        scan(as_view<view_type>(str), [&res](size_t pattern, size_t pos){ res.push_back(match{pattern, pos}); });
+        return res;
+    }
+
+    template<typename StringT>
+    bool contains_any(const StringT& str) const{
+        view_type text = as_view<view_type>(str);
+        uint32_t state = 0;
+        for(size_t i = 0; i < text.size(); ++i){
+            state = step(state, code(text[i]));
+            if(out_[state + 1] != out_[state] || dict_[state] != none) return true;
+        }
+        return false;
+    }
+};
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <string.hpp>
+#include <cow_string.hpp>
+#include <aho_corasick.hpp>
+#include <string_view>
+#include <vector>
+#include <stdexcept>
+#include <cassert>
+#include <iostream>
+
+void Test_aho_classic(){
+    std::vector<my::string> patterns{"he", "she", "his", "hers"};
+    my::aho_corasick<char> matcher(patterns.begin(), patterns.end());
+    assert(matcher.size() == 4);
+
+    auto matches = matcher.find_all(my::cow_string("ushers"));
+    assert(matches.size() == 3);
+    assert(matches[0].pattern == 1 && matches[0].pos == 1);
+    assert(matches[1].pattern == 0 && matches[1].pos == 2);
+    assert(matches[2].pattern == 3 && matches[2].pos == 2);
+
+    assert(matcher.contains_any(my::string("this is his")));
+    assert(!matcher.contains_any(std::string_view("nothing to see")));
+}
+
+void Test_aho_brute_force(){
+    my::aho_corasick<char> matcher{"ERROR", "WARN", "timeout", "time", "a", "aa", "ERROR"};
+    std::vector<std::string_view> patterns{"ERROR", "WARN", "timeout", "time", "a", "aa", "ERROR"};
+    std::string_view line = "WARN: request timeout after 30s, ERROR aaa timed out";
+
+    std::vector<size_t> hits(patterns.size(), 0);
+    size_t total = 0;
+    matcher.scan(line, [&](size_t id, size_t pos){
+        assert(line.substr(pos, patterns[id].size()) == patterns[id]);
+        hits[id]++;
+        total++;
+    });
+
+    size_t expected = 0;
+    for(size_t id = 0; id < patterns.size(); ++id){
+        size_t count = 0;
+        for(size_t pos = line.find(patterns[id]); pos != std::string_view::npos; pos = line.find(patterns[id], pos + 1)) count++;
+        assert(hits[id] == count);
+        expected += count;
+    }
+    assert(total == expected);
+}
+
+void Test_aho_empty_pattern(){
+    bool thrown = false;
+    try{ my::aho_corasick<char> matcher{"he", "", "she"}; }
+    catch(const std::invalid_argument&){ thrown = true; }
+    assert(thrown);
+
+    thrown = false;
+    std::vector<my::cow_string> patterns{"he", my::cow_string()};
+    try{ my::aho_corasick<char> matcher(patterns.begin(), patterns.end()); }
+    catch(const std::invalid_argument&){ thrown = true; }
+    assert(thrown);
+}
+
+void Test_aho_corasick(){
+    Test_aho_classic();
+    Test_aho_brute_force();
+    Test_aho_empty_pattern();
+    std::cout << "Aho-Corasick tests passed\n";
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+
+namespace my {
+
+template<typename Allocator,
+         bool = std::is_empty_v<Allocator> && !std::is_final_v<Allocator>>
+class allocator_holder : private Allocator{
+
+public:
+
+    allocator_holder() = default;
+
+    explicit allocator_holder(const Allocator& alloc) : Allocator(alloc) {}
+
+    Allocator& alloc(){
+        return *this;
+    }
+
+    const Allocator& alloc() const{
+        return *this;
+    }
+};
+
+template<typename Allocator>
+class allocator_holder<Allocator, false>{
+
+    Allocator alloc_;
+
+public:
+
+    allocator_holder() = default;
+
+    explicit allocator_holder(const Allocator& alloc) : alloc_(alloc) {}
+
+    Allocator& alloc(){
+        return alloc_;
+    }
+
+    const Allocator& alloc() const{
+        return alloc_;
+    }
+};
+
+}
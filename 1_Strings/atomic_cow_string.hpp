@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cow_string.hpp>
+#include <test_hooks.hpp>
+
+namespace my {
+
+template<typename CharT,
+         typename TraitsT = std::char_traits<CharT>,
+         typename Allocator = std::allocator<CharT>>
+class atomic_cow_base_string : private allocator_holder<Allocator>{
+
+    using string_type  = cow_base_string<CharT, TraitsT, Allocator>;
+    using block_type   = typename string_type::ControlBlock;
+    using holder       = allocator_holder<Allocator>;
+
+    static_assert(sizeof (void*) == sizeof (uint64_t), "pointer tagging needs 64-bit pointers");
+
+    static constexpr unsigned tag_shift = 48;
+    static constexpr uint64_t one       = uint64_t(1) << tag_shift;
+    static constexpr uint64_t ptr_mask  = one - 1;
+
+    mutable std::atomic<uint64_t> word_{0};
+
+    static block_type* pointer(uint64_t word){
+        return reinterpret_cast<block_type*>(word & ptr_mask);
+    }
+
+    static uint64_t borrowed(uint64_t word){
+        return word >> tag_shift;
+    }
+
+    static uint64_t pack(block_type* block){
+        assert((reinterpret_cast<uint64_t>(block) & ~ptr_mask) == 0);
+        return reinterpret_cast<uint64_t>(block);
+    }
+
+    static void add_refs(block_type* block, uint64_t n){
+        if(block && n && !block->immortal) block->ref.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    static void sub_refs(block_type* block, uint64_t n){
+        if(block && n && !block->immortal) block->ref.fetch_sub(n, std::memory_order_relaxed);
+    }
+
+    static block_type* take(string_type&& str){
+        block_type* block = str.info;
+        str.info = nullptr;
+        return block;
+    }
+
+    string_type adopt(block_type* block) const{
+        string_type res(this->alloc());
+        res.info = block;
+        return res;
+    }
+
+    uint64_t borrow() const{
+        return word_.fetch_add(one, std::memory_order_acquire) + one;
+    }
+
+    string_type settle(uint64_t cur) const{
+        block_type* block = pointer(cur);
+        MY_STRING_STEP(atomic_borrowed);
+        if(block) string_type::acquire(block);
+        while(true){
+            if(pointer(cur) != block || borrowed(cur) == 0){
+                if(block) string_type::release(block);
+                break;
+            }
+            if(word_.compare_exchange_weak(cur, cur - one, std::memory_order_acquire)) break;
+        }
+        return adopt(block);
+    }
+
+    template<typename Accept>
+    bool publish(uint64_t desired, uint64_t& cur, Accept&& accept){
+        cur = borrow();
+        while(accept(pointer(cur))){
+            block_type* block = pointer(cur);
+            const uint64_t lent = borrowed(cur);
+            add_refs(block, lent);
+            MY_STRING_STEP(atomic_publishing);
+            if(word_.compare_exchange_weak(cur, desired, std::memory_order_acq_rel, std::memory_order_acquire)){
+                cur = pack(block);
+                return true;
+            }
+            sub_refs(block, lent);
+            if(pointer(cur) != block){
+                if(block) string_type::release(block);
+                cur = borrow();
+            }
+        }
+        return false;
+    }
+
+public:
+
+    static constexpr bool is_always_lock_free = std::atomic<uint64_t>::is_always_lock_free;
+
+    explicit atomic_cow_base_string(const Allocator& alloc = Allocator()) : holder(alloc) {}
+
+    explicit atomic_cow_base_string(string_type str) : holder(str.get_allocator()){
+        word_.store(pack(take(std::move(str))), std::memory_order_relaxed);
+    }
+
+    atomic_cow_base_string(const atomic_cow_base_string&) = delete;
+    atomic_cow_base_string& operator=(const atomic_cow_base_string&) = delete;
+
+    ~atomic_cow_base_string(){
+        block_type* block = pointer(word_.load(std::memory_order_acquire));
+        if(block) string_type::release(block);
+    }
+
+    string_type load() const{
+        return settle(borrow());
+    }
+
+    void store(string_type str){
+        uint64_t old;
+        publish(pack(take(std::move(str))), old, [](block_type*){ return true; });
+        if(pointer(old)){
+            string_type::release(pointer(old));
+            string_type::release(pointer(old));
+        }
+    }
+
+    string_type exchange(string_type str){
+        uint64_t old;
+        publish(pack(take(std::move(str))), old, [](block_type*){ return true; });
+        if(pointer(old)) string_type::release(pointer(old));
+        return adopt(pointer(old));
+    }
+
+    bool compare_exchange_strong(string_type& expected, string_type desired){
+        uint64_t cur;
+        if(publish(pack(desired.info), cur, [&expected](block_type* block){ return block == expected.info; })){
+            take(std::move(desired));
+            if(pointer(cur)){
+                string_type::release(pointer(cur));
+                string_type::release(pointer(cur));
+            }
+            return true;
+        }
+        expected = settle(cur);
+        return false;
+    }
+
+    operator string_type() const{
+        return load();
+    }
+
+    atomic_cow_base_string& operator=(string_type str){
+        store(std::move(str));
+        return *this;
+    }
+};
+
+using atomic_cow_string = my::atomic_cow_base_string<char>;
+
+}
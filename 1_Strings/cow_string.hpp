@@ -2,38 +2,132 @@
 
 #include <atomic>
 #include <stdexcept>
+#include <algorithm>
 #include <cstring>
+#include <memory_resource>
+#include <string_view>
 #include <iterator.hpp>
+#include <search.hpp>
+#include <allocator.hpp>
+#include <pool.hpp>
+#include <instrumentation.hpp>
+#include <numeric.hpp>
 
 namespace my {
 
+namespace pipeline {
+template<typename, typename, typename, size_t>
+class cow_channel;
+}
+
 template<typename CharT,
          typename TraitsT = std::char_traits<CharT>,
          typename Allocator = std::allocator<CharT>>
 
-class cow_base_string{
+class cow_base_string : private allocator_holder<Allocator>{
 
-    using it       = StringIterator<CharT>;
-    using const_it = StringIterator<const CharT>;
+    using it           = StringIterator<CharT>;
+    using const_it     = StringIterator<const CharT>;
+    using holder       = allocator_holder<Allocator>;
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using view_type    = std::basic_string_view<CharT, TraitsT>;
 
-
-    struct ControlBlock{
+    struct ControlBlock : allocator_holder<Allocator>{
         CharT* data = nullptr;
         size_t size = 0;
         size_t cap  = 0;
-        std::atomic<size_t> ref;
+        std::atomic<size_t> ref{0};
+        ControlBlock* parent = nullptr;
+        bool immortal = false;
+        void (*dispose)(ControlBlock*) = nullptr;
+
+        explicit ControlBlock(const Allocator& alloc) : allocator_holder<Allocator>(alloc) {}
     };
 
+    template<typename Deleter>
+    struct ExternalBlock : ControlBlock{
+        Deleter deleter;
+
+        using self_alloc  = typename alloc_traits::template rebind_alloc<ExternalBlock>;
+        using self_traits = std::allocator_traits<self_alloc>;
+
+        ExternalBlock(const Allocator& alloc, Deleter&& d) : ControlBlock(alloc), deleter(std::move(d)){
+            this->dispose = &ExternalBlock::destroy;
+        }
+
+        static void destroy(ControlBlock* block){
+            ExternalBlock* self = static_cast<ExternalBlock*>(block);
+            self->deleter(self->data);
+            MY_STRING_RECORD(dealloc);
+            self_alloc alloc(self->alloc());
+            self->~ExternalBlock();
+            self_traits::deallocate(alloc, self, 1);
+        }
+    };
+
+    using block_alloc  = typename alloc_traits::template rebind_alloc<ControlBlock>;
+    using block_traits = std::allocator_traits<block_alloc>;
+
     ControlBlock* info = nullptr;
 
+    static CharT* allocate(Allocator& alloc, size_t n){
+        MY_STRING_RECORD_ALLOC(n * sizeof (CharT));
+        return alloc_traits::allocate(alloc, n);
+    }
+
+    static void deallocate(Allocator& alloc, CharT* data, size_t n){
+        MY_STRING_RECORD(dealloc);
+        alloc_traits::deallocate(alloc, data, n);
+    }
+
+    ControlBlock* new_block() const{
+        MY_STRING_RECORD_ALLOC(sizeof (ControlBlock));
+        block_alloc alloc(this->alloc());
+        ControlBlock* block = block_traits::allocate(alloc, 1);
+        ::new (static_cast<void*>(block)) ControlBlock(this->alloc());
+        return block;
+    }
+
+    static void delete_block(ControlBlock* block){
+        MY_STRING_RECORD(dealloc);
+        block_alloc alloc(block->alloc());
+        block->~ControlBlock();
+        block_traits::deallocate(alloc, block, 1);
+    }
+
+    static void acquire(ControlBlock* block){
+        if(!block->immortal) block->ref.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void release(ControlBlock* block){
+        if(block->immortal) return;
+        if(block->ref.fetch_sub(1, std::memory_order_acq_rel) == 1){
+            if(block->dispose){
+                block->dispose(block);
+                return;
+            }
+            if(block->parent) release(block->parent);
+            else              deallocate(block->alloc(), block->data, block->cap);
+            delete_block(block);
+        }
+    }
+
+    void share(const cow_base_string& str){
+        if(!str.info) return;
+        if(str.info->immortal || this->alloc() == str.info->alloc()){
+            MY_STRING_RECORD(cow_share);
+            info = str.info;
+            acquire(info);
+        }
+        else if(str.info->data){
+            MY_STRING_RECORD(deep_copy);
+            create(str.info->data, str.info->size);
+        }
+    }
+
     bool clean(){
         if(info && info->data){
-            info->ref.fetch_sub(1);
-            if(info->ref.load() == 0){
-                Allocator alloc;
-                alloc.deallocate(info->data, info->size);
-                delete info;
-            }
+            release(info);
             info = nullptr;
             return true;
         }
@@ -41,112 +135,225 @@ class cow_base_string{
     }
 
     void restore(size_t sft = 0){
-        Allocator alloc;
-        if(info->ref.load() > 1){
+        if(info->immortal || info->parent || (sft != 0 && info->dispose) || info->ref.load(std::memory_order_acquire) > 1){
+            MY_STRING_RECORD(cow_detach);
+            ControlBlock* prev = info;
             CharT* data = info->data;
             size_t size = info->size + sft;
             size_t cap = info->cap;
-            info->ref.fetch_sub(1);
-            info = new ControlBlock();
+            info = new_block();
 
             if(cap <= size) cap = 2 * size;
-            info->data = alloc.allocate(cap);
-            std::memcpy(info->data, data, size - sft);
+            info->data = allocate(info->alloc(), cap);
+            TraitsT::copy(info->data, data, size - sft);
             info->size = size;
             info->cap  = cap;
-            info->ref.fetch_add(1);
+            info->ref.fetch_add(1, std::memory_order_relaxed);
+            release(prev);
         }
         else if(sft != 0){
             CharT* data = info->data;
             size_t size = info->size + sft;
             size_t cap = info->cap;
             size_t prev_cap = cap;
-            if(cap <= size) cap = 2 * size;
-            info->data = alloc.allocate(cap);
-            std::memcpy(info->data, data, size - sft);
+            if(size < cap){
+                info->size = size;
+                return;
+            }
+            cap = 2 * size;
+            info->data = allocate(info->alloc(), cap);
+            TraitsT::copy(info->data, data, size - sft);
             info->size = size;
             info->cap  = cap;
-            alloc.deallocate(data, prev_cap);
+            deallocate(info->alloc(), data, prev_cap);
         }
     }
 
+    CharT* create_exact(size_t n){
+        info = new_block();
+        info->data = allocate(info->alloc(), n);
+        info->size = n;
+        info->cap  = n;
+        info->ref.fetch_add(1, std::memory_order_relaxed);
+        return info->data;
+    }
+
+    static cow_base_string slice(const cow_base_string& owner, size_t pos, size_t n){
+        cow_base_string res(owner.alloc());
+        res.info = res.new_block();
+        res.info->parent = owner.info;
+        acquire(owner.info);
+        res.info->data = owner.info->data + pos;
+        res.info->size = n + 1;
+        res.info->cap  = n + 1;
+        res.info->ref.fetch_add(1, std::memory_order_relaxed);
+        return res;
+    }
+
+    bool unique() const{
+        return info && info->data && !info->immortal && !info->parent && info->ref.load(std::memory_order_acquire) == 1;
+    }
+
+    template<typename F>
+    void rebuild(size_t n, size_t cap, F fill){
+        ControlBlock* prev = info;
+        if(prev && prev->ref.load(std::memory_order_acquire) > 1) MY_STRING_RECORD(cow_detach);
+        CharT* out = create_exact(cap);
+        info->size = n;
+        fill(out);
+        out[n - 1] = CharT();
+        if(prev) release(prev);
+    }
+
+    template<typename, typename, typename>
+    friend class split_arena;
+
+    template<typename, typename, typename>
+    friend class base_string_column;
+
+    template<typename, typename, typename>
+    friend class atomic_cow_base_string;
+
+    template<typename, typename, typename>
+    friend class base_snapshot;
+
+    template<typename, typename, typename, size_t>
+    friend class pipeline::cow_channel;
+
     void create(const CharT* data, size_t n, bool sft = false, bool nb = true){
-        Allocator alloc;
-        if(nb) info = new ControlBlock();
-        info->data = alloc.allocate(2 * n);
-        std::memcpy(info->data, data, n);
+        if(nb) info = new_block();
+        info->data = allocate(info->alloc(), 2 * n);
+        TraitsT::copy(info->data, data, sft ? n - 1 : n);
         info->ref.fetch_add(1);
         info->size = n;
         info->cap  = 2 * n;
-        if(!sft) info->data[n]     = '\0';
-        else     info->data[n - 1] = '\0';
+        if(!sft) info->data[n]     = CharT();
+        else     info->data[n - 1] = CharT();
     }
 
 public:
 
-    ~cow_base_string(){
-        if(info){
-            if(info->ref.load() == 1){
-                Allocator alloc;
-                alloc.deallocate(info->data, info->cap);
-                delete info;
-            }
-            else
-                info->ref.fetch_sub(1);
+    class literal_block{
+
+        ControlBlock block;
+
+        friend class cow_base_string;
+
+    public:
+
+        template<size_t N>
+        explicit literal_block(const CharT (&data)[N]) : block(Allocator()){
+            block.data = const_cast<CharT*>(&data[0]);
+            block.size = N;
+            block.cap  = N;
+            block.ref.store(1, std::memory_order_relaxed);
+            block.immortal = true;
         }
+
+        literal_block(const literal_block&) = delete;
+        literal_block& operator=(const literal_block&) = delete;
+    };
+
+    ~cow_base_string(){
+        if(info) release(info);
     }
 
     cow_base_string() = default;
 
-    cow_base_string(size_t n){
-        info = new ControlBlock();
-        Allocator alloc;
-        info->data = alloc.allocate(2 * n);
+    explicit cow_base_string(const Allocator& alloc) : holder(alloc) {}
+
+    cow_base_string(size_t n, const Allocator& alloc = Allocator()) : holder(alloc){
+        info = new_block();
+        info->data = allocate(info->alloc(), 2 * n);
         info->size = n;
         info->cap  = 2 * n;
         info->ref.fetch_add(1);
-        info->data[info->size] = '\0';
+        info->data[info->size] = CharT();
     }
 
-    cow_base_string(const CharT* data, size_t n){
-        create(data, n + 1);
+    cow_base_string(const CharT* data, size_t n, const Allocator& alloc = Allocator()) : holder(alloc){
+        create(data, n + 1, true);
     }
 
-    cow_base_string(const CharT* data){
-        size_t n = std::strlen(data) + 1;
+    cow_base_string(const CharT* data, const Allocator& alloc = Allocator()) : holder(alloc){
+        size_t n = TraitsT::length(data) + 1;
         create(data, n);
     }
 
     template<size_t N>
-    cow_base_string(const CharT (&data)[N]){
+    cow_base_string(const CharT (&data)[N], const Allocator& alloc = Allocator()) : holder(alloc){
         create(&data[0], N);
     }
 
-    cow_base_string(const_it beg, const_it end){
+    explicit cow_base_string(const literal_block& lit, const Allocator& alloc = Allocator()) : holder(alloc){
+        info = const_cast<ControlBlock*>(&lit.block);
+    }
+
+    template<typename Deleter>
+    static cow_base_string adopt(CharT* data, size_t n, size_t cap, Deleter deleter, const Allocator& alloc = Allocator()){
+        if(cap <= n){
+            deleter(data);
+            throw std::length_error("Adopted buffer has no room for the terminator");
+        }
+        using block_type = ExternalBlock<Deleter>;
+        typename block_type::self_alloc ext_alloc(alloc);
+        block_type* block = nullptr;
+        try{
+            block = block_type::self_traits::allocate(ext_alloc, 1);
+        }
+        catch(...){
+            deleter(data);
+            throw;
+        }
+        MY_STRING_RECORD_ALLOC(sizeof (block_type));
+        ::new (static_cast<void*>(block)) block_type(alloc, std::move(deleter));
+        block->data = data;
+        block->size = n + 1;
+        block->cap  = cap;
+        block->ref.store(1, std::memory_order_relaxed);
+        data[n] = CharT();
+        cow_base_string res(alloc);
+        res.info = block;
+        return res;
+    }
+
+    cow_base_string(const_it beg, const_it end, const Allocator& alloc = Allocator()) : holder(alloc){
         assign(beg, end);
     }
 
-    cow_base_string(const cow_base_string& str){
-        info = str.info;
-        info->ref.fetch_add(1);
+    cow_base_string(const cow_base_string& str)
+        : holder(alloc_traits::select_on_container_copy_construction(str.alloc())){
+        share(str);
     }
 
-    cow_base_string(cow_base_string&& str){
+    cow_base_string(const cow_base_string& str, const Allocator& alloc) : holder(alloc){
+        share(str);
+    }
+
+    cow_base_string(cow_base_string&& str) : holder(str.alloc()){
         info = str.info;
         str.info = nullptr;
     }
 
     cow_base_string& operator=(const cow_base_string& str){
+        if(info == str.info) return *this;
         clean();
-        info = str.info;
-        info->ref.fetch_add(1);
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+            this->alloc() = str.alloc();
+        share(str);
         return *this;
     }
 
     cow_base_string& operator=(cow_base_string&& str){
+        if(this == &str) return *this;
         clean();
-        info = str.info;
-        str.info = nullptr;
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+            this->alloc() = str.alloc();
+        if(!str.info || this->alloc() == str.info->alloc()){
+            info = str.info;
+            str.info = nullptr;
+        }
+        else share(str);
         return *this;
     }
 
@@ -171,6 +378,7 @@ public:
 
         if(!str.info || !info || str.info->size != info->size) return false;
 
+        if constexpr (std::is_same_v<CharU, CharT>) return search::compare<TraitsT>(info->data, str.info->data, info->size - 1) == 0;
         for(size_t i = 0; i < info->size - 1; ++i)
             if(!TraitsT::eq(info->data[i], str.info->data[i])) return false;
 
@@ -186,6 +394,7 @@ public:
 
         if(!str.info || !info || str.info->size != info->size) return false;
 
+        if constexpr (std::is_same_v<CharU, CharT>) return search::compare<TraitsT>(info->data, str.info->data, info->size - 1) == 0;
         for(size_t i = 0; i < info->size - 1; ++i)
             if(!TraitsT::eq(info->data[i], str.info->data[i])) return false;
 
@@ -231,12 +440,14 @@ public:
     template<size_t N>
     cow_base_string operator+(const CharT (&arr)[N]) const{
         if(N == 0) return *this;
-        if(!info || !info->data) return cow_base_string(arr);
-        Allocator alloc;
-        CharT* data = alloc.allocate(N + info->size - 1);
-        std::memcpy(data, info->data, info->size - 1);
-        std::memcpy(data + info->size - 1, arr, N);
-        return cow_base_string(data, N + info->size - 2);
+        if(!info || !info->data) return cow_base_string(arr, this->alloc());
+        Allocator alloc(this->alloc());
+        CharT* data = allocate(alloc, N + info->size - 1);
+        TraitsT::copy(data, info->data, info->size - 1);
+        TraitsT::copy(data + info->size - 1, arr, N);
+        cow_base_string res(data, N + info->size - 2, this->alloc());
+        deallocate(alloc, data, N + info->size - 1);
+        return res;
     };
 
     template<typename CharU,
@@ -245,11 +456,13 @@ public:
     cow_base_string operator+(const cow_base_string<CharU, TraitsU, AllocatorU>& other) const{
         if(!other.info || !other.info->data) return *this;
         if(!info || !info->data) return other;
-        Allocator alloc;
-        CharT* data = alloc.allocate(other.info->size + info->size - 1);
-        std::memcpy(data, info->data, info->size - 1);
-        std::memcpy(data + info->size - 1, other.info->data, other.info->size);
-        return cow_base_string(data, other.info->size + info->size - 2);
+        Allocator alloc(this->alloc());
+        CharT* data = allocate(alloc, other.info->size + info->size - 1);
+        TraitsT::copy(data, info->data, info->size - 1);
+        TraitsT::copy(data + info->size - 1, other.info->data, other.info->size - 1);
+        cow_base_string res(data, other.info->size + info->size - 2, this->alloc());
+        deallocate(alloc, data, other.info->size + info->size - 1);
+        return res;
     };
 
     template<size_t N>
@@ -264,7 +477,7 @@ public:
         else{
             size_t prev_size = info->size;
             restore(N - 1);
-            std::memcpy(info->data + prev_size - 1, arr, N);
+            TraitsT::copy(info->data + prev_size - 1, arr, N);
         }
         return *this;
     };
@@ -275,16 +488,18 @@ public:
     cow_base_string& operator+=(const cow_base_string<CharU, TraitsU, AllocatorU>& other){
         if(!other.info || !other.info->data || other.size() == 0) return *this;
         if(!info){
-            info = other.info;
+            share(other);
         }
         else if(!info->data){
-            delete info;
-            info = other.info;
+            delete_block(info);
+            info = nullptr;
+            share(other);
         }
         else{
             size_t prev_size = info->size;
             restore(other.info->size - 1);
-            std::memcpy(info->data + prev_size - 1, other.info->data, other.info->size);
+            TraitsT::copy(info->data + prev_size - 1, other.info->data, other.info->size - 1);
+            info->data[info->size - 1] = CharT();
         }
         return *this;
     };
@@ -347,7 +562,7 @@ public:
     }
 
     const_it cend() const{
-        if(info && info->data && info->size >= 1) return const_it(&(info->data[info->size]));
+        if(info && info->data && info->size >= 1) return const_it(&(info->data[info->size - 1]));
         return const_it();
     }
 
@@ -363,6 +578,10 @@ public:
         return info->cap;
     }
 
+    Allocator get_allocator() const{
+        return this->alloc();
+    }
+
     size_t references() const{
         if(!info) return 0;
         return info->ref.load();
@@ -395,37 +614,38 @@ public:
     }
 
     cow_base_string copy() const{
-        if(!info || !info->data) return cow_base_string();
-        return cow_base_string(info->data, info->size);
+        if(!info || !info->data) return cow_base_string(this->alloc());
+        MY_STRING_RECORD(deep_copy);
+        return cow_base_string(info->data, info->size - 1, this->alloc());
     }
 
     void assign(const_it beg, const_it end){
-        Allocator alloc;
         size_t size = end - beg + 1;
-        CharT* data = alloc.allocate(size);
-        std::memcpy(data, &(*beg), size - 1);
+        CharT* data = allocate(this->alloc(), size);
+        TraitsT::copy(data, &(*beg), size - 1);
         clean();
-        if(!info) info = new ControlBlock();
+        if(!info) info = new_block();
         info->data = data;
         info->size = size;
+        info->cap  = size;
         info->ref.fetch_add(1);
-        data[size - 1] = '\0';
+        data[size - 1] = CharT();
     }
 
     cow_base_string substr(size_t beg, size_t end) const{
-        if(!info || !info->data) return cow_base_string();
+        if(!info || !info->data) return cow_base_string(this->alloc());
         if(end - beg == info->size - 1) return copy();
         const_it start = std::next(cbegin(), beg);
         const_it fin = std::next(cbegin(), end);
-        cow_base_string str;
+        cow_base_string str(this->alloc());
         str.assign(start, fin);
         return str;
     }
 
     cow_base_string substr(const_it beg, const_it end) const{
-        if(!info || !info->data) return cow_base_string();
+        if(!info || !info->data) return cow_base_string(this->alloc());
         if(end - beg == info->size - 1) return copy();
-        cow_base_string str;
+        cow_base_string str(this->alloc());
         str.assign(beg, end);
         return str;
     }
@@ -434,15 +654,15 @@ public:
     it find(CharT v){
         if(!info || !info->data) return it();
         if(info && info->data) restore();
-        for(size_t idx = 0; idx < size(); ++idx)
-            if(TraitsT::eq(v, info->data[idx])) return it(&(info->data[idx]));
+        const CharT* hit = search::find_char<TraitsT>(info->data, size(), v);
+        if(hit) return it(info->data + (hit - info->data));
         return end();
     }
 
     const_it cfind(CharT v) const{
         if(!info || !info->data) return const_it();
-        for(size_t idx = 0; idx < size(); ++idx)
-            if(TraitsT::eq(v, info->data[idx])) return const_it(&(info->data[idx]));
+        const CharT* hit = search::find_char<TraitsT>(info->data, size(), v);
+        if(hit) return const_it(hit);
         return cend();
     }
 
@@ -480,33 +700,120 @@ public:
     }
 
     size_t count(CharT v) const{
-        size_t res = 0;
-        for(size_t idx = 0; idx < size(); ++idx) if(TraitsT::eq(v, info->data[idx])) res++;
-        return res;
+        if(!info || !info->data) return 0;
+        return search::count_char<TraitsT>(info->data, size(), v);
+    }
+
+    cow_base_string& replace(size_t pos, size_t len, view_type str){
+        const size_t old = size();
+        if(pos > old) throw std::out_of_range("");
+        if(len > old - pos) len = old - pos;
+        const size_t tail = old - pos - len;
+        const size_t n = old - len + str.size() + 1;
+        const CharT* src = old ? info->data : nullptr;
+        if(unique() && n <= info->cap && !search::overlaps(src, old, str.data(), str.size())){
+            TraitsT::move(info->data + pos + str.size(), info->data + pos + len, tail);
+            TraitsT::copy(info->data + pos, str.data(), str.size());
+            info->data[n - 1] = CharT();
+            info->size = n;
+            return *this;
+        }
+        rebuild(n, n > capacity() ? std::max(n, 2 * old) : n, [&](CharT* out){
+            TraitsT::copy(out, src, pos);
+            TraitsT::copy(out + pos, str.data(), str.size());
+            TraitsT::copy(out + pos + str.size(), src + pos + len, tail);
+        });
+        return *this;
     }
 
-    void push_back(const CharT& el){
-        if(!info || !info->data)
-            create(&el, 2, true);
-        return;
+    size_t replace_all(view_type needle, view_type str){
+        const size_t old = size();
+        if(old == 0) return 0;
+        const size_t matches = search::count<TraitsT>(info->data, old, needle.data(), needle.size());
+        if(matches == 0) return 0;
+        const size_t n = old - matches * needle.size() + matches * str.size() + 1;
+        const CharT* src = info->data;
+        if(unique() && n <= info->cap && !search::overlaps(src, old, str.data(), str.size())
+                                      && !search::overlaps(src, old, needle.data(), needle.size())){
+            if(n - 1 > old){
+                src = info->data + (n - 1 - old);
+                TraitsT::move(info->data + (n - 1 - old), info->data, old);
+            }
+            search::replace_copy<TraitsT>(info->data, src, old, needle.data(), needle.size(), str.data(), str.size());
+            info->data[n - 1] = CharT();
+            info->size = n;
+            return matches;
+        }
+        rebuild(n, n, [&](CharT* out){
+            search::replace_copy<TraitsT>(out, src, old, needle.data(), needle.size(), str.data(), str.size());
+        });
+        return matches;
+    }
 
-        if(info->size == info->cap) restore();
-        info->data[info->size]   = el;
-        info->data[++info->size] = '\0';
+    template<typename F>
+    void resize_and_overwrite(size_t count, F op){
+        const size_t n = count + 1;
+        if(info && !info->data){
+            delete_block(info);
+            info = nullptr;
+        }
+        if(!unique() || n > info->cap){
+            ControlBlock* prev = info;
+            const size_t keep = std::min(size(), count);
+            if(prev && prev->ref.load(std::memory_order_acquire) > 1) MY_STRING_RECORD(cow_detach);
+            CharT* data = create_exact(std::max(n, 2 * keep));
+            if(keep) TraitsT::copy(data, prev->data, keep);
+            data[keep] = CharT();
+            info->size = keep + 1;
+            if(prev) release(prev);
+        }
+        const size_t res = op(info->data, count);
+        info->data[res] = CharT();
+        info->size = res + 1;
+    }
+
+    template<typename T>
+    cow_base_string& append_int(T value){
+        static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "append_int formats integers");
+        const size_t old = size();
+        const size_t len = numeric::digits(value);
+        resize_and_overwrite(old + len, [&](CharT* out, size_t n){
+            numeric::format(out + old, len, value);
+            return n;
+        });
+        return *this;
+    }
 
+    cow_base_string& append_double(double value){
+        CharT buf[numeric::max_chars<double>];
+        const size_t len = numeric::format(buf, numeric::max_chars<double>, value);
+        const size_t old = size();
+        resize_and_overwrite(old + len, [&](CharT* out, size_t n){
+            TraitsT::copy(out + old, buf, len);
+            return n;
+        });
+        return *this;
     }
 
-    void push_back(CharT&& el){
+    template<typename T>
+    T to_number() const{
+        return numeric::to_number<T>(c_str(), size());
+    }
+
+    void push_back(const CharT& el){
         if(!info || !info->data){
-            create(&el, 2, true);
+            CharT data[2] = {el, CharT()};
+            create(data, 2);
             return;
         }
 
-        if(info->size == info->cap) restore();
+        restore(1);
+        info->data[info->size - 2] = el;
+        info->data[info->size - 1] = CharT();
+    }
 
-        info->data[info->size - 1]   = el;
-        info->data[info->size] = '\0';
-        info->size++;
+    void push_back(CharT&& el){
+        push_back(static_cast<const CharT&>(el));
     }
 
     void erase(const_it targ){
@@ -518,6 +825,7 @@ public:
             idx++;
             it = std::next(it, 1);
         }
+        restore();
         for(size_t i = idx; i < info->size - 1; ++i){
             std::swap(info->data[idx], info->data[idx + 1]);
         }
@@ -557,4 +865,20 @@ std::basic_ostream<CharU, TraitsU>& operator<<(std::basic_ostream<CharU, TraitsU
 
 namespace my {
 using cow_string = my::cow_base_string<char>;
+
+namespace pmr {
+template<typename CharT,
+         typename TraitsT = std::char_traits<CharT>>
+using cow_base_string = my::cow_base_string<CharT, TraitsT, std::pmr::polymorphic_allocator<CharT>>;
+
+using cow_string = my::pmr::cow_base_string<char>;
+}
+
+namespace pooled {
+template<typename CharT,
+         typename TraitsT = std::char_traits<CharT>>
+using cow_base_string = my::cow_base_string<CharT, TraitsT, my::pool_allocator<CharT>>;
+
+using cow_string = my::pooled::cow_base_string<char>;
+}
 }
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cow_string.hpp>
+#include <string_bench.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <cassert>
+#include <iostream>
+
+namespace my {
+namespace stress {
+
+struct live_counter{
+    std::atomic<long long> blocks{0};
+    std::atomic<long long> bytes{0};
+};
+
+inline live_counter& live(){
+    static live_counter c;
+    return c;
+}
+
+template<typename T>
+struct tracking_allocator{
+
+    using value_type = T;
+
+    tracking_allocator() = default;
+
+    template<typename U>
+    tracking_allocator(const tracking_allocator<U>&){}
+
+    T* allocate(size_t n){
+        live().blocks.fetch_add(1, std::memory_order_relaxed);
+        live().bytes.fetch_add(n * sizeof (T), std::memory_order_relaxed);
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n){
+        live().blocks.fetch_sub(1, std::memory_order_relaxed);
+        live().bytes.fetch_sub(n * sizeof (T), std::memory_order_relaxed);
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template<typename U>
+    bool operator==(const tracking_allocator<U>&) const{
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const tracking_allocator<U>&) const{
+        return false;
+    }
+};
+
+using cow_string = my::cow_base_string<char, std::char_traits<char>, tracking_allocator<char>>;
+
+class start_gate{
+
+    std::atomic<size_t> ready{0};
+    std::atomic<bool>   go{false};
+
+public:
+
+    void arrive(){
+        ready.fetch_add(1);
+        while(!go.load(std::memory_order_acquire)) std::this_thread::yield();
+    }
+
+    void open(size_t n){
+        while(ready.load() != n) std::this_thread::yield();
+        go.store(true, std::memory_order_release);
+    }
+};
+
+template<typename F>
+std::chrono::nanoseconds run_threads(size_t n, F&& body){
+    start_gate gate;
+    std::vector<std::thread> threads;
+    threads.reserve(n);
+    for(size_t tid = 0; tid < n; ++tid){
+        threads.emplace_back([&gate, &body, tid]{
+            gate.arrive();
+            body(tid);
+        });
+    }
+    gate.open(n);
+    auto start = std::chrono::steady_clock::now();
+    for(auto& th : threads) th.join();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+}
+
+inline unsigned next_random(unsigned& state){
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+inline void stress_cow_string(size_t threads, size_t iterations){
+    const long long blocks_before = live().blocks.load();
+    {
+        const char msg[] = "Shared refcount stress payload";
+        cow_string shared(msg);
+
+        run_threads(threads, [&](size_t tid){
+            unsigned state = 2463534242u + unsigned(tid);
+            cow_string slots[4];
+            for(size_t i = 0; i < iterations; ++i){
+                cow_string& slot = slots[next_random(state) % 4];
+                switch(next_random(state) % 6){
+                case 0:{
+                    cow_string copy(shared);
+                    assert(copy.references() >= 2);
+                    break;
+                }
+                case 1:
+                    slot = shared;
+                    break;
+                case 2:
+                    slot = std::move(slots[next_random(state) % 4]);
+                    break;
+                case 3:{
+                    cow_string copy(shared);
+                    copy[0] = 'X';
+                    assert(copy.references() == 1);
+                    assert(copy[0] == 'X');
+                    break;
+                }
+                case 4:
+                    slot = shared;
+                    slot.push_back('+');
+                    assert(slot.references() == 1);
+                    break;
+                default:
+                    slot = cow_string();
+                    break;
+                }
+            }
+        });
+
+        assert(shared.references() == 1);
+        assert(shared == msg);
+    }
+    assert(live().blocks.load() == blocks_before);
+}
+
+struct scenario{
+    const char* name;
+    size_t strings;
+    size_t spacing;
+};
+
+inline my::bench::result measure_copies(const scenario& sc, size_t threads, size_t copies){
+    std::vector<std::unique_ptr<char[]>> spacers;
+    std::vector<cow_string> sources;
+    sources.reserve(threads);
+    for(size_t i = 0; i < (sc.strings == 1 ? 1 : threads); ++i){
+        sources.emplace_back("refcount");
+        if(sc.spacing) spacers.emplace_back(new char[sc.spacing]);
+    }
+
+    auto elapsed = run_threads(threads, [&](size_t tid){
+        const cow_string& src = sources[sc.strings == 1 ? 0 : tid];
+        for(size_t i = 0; i < copies; ++i){
+            cow_string copy(src);
+            my::bench::do_not_optimize(copy);
+        }
+    });
+
+    my::bench::result r;
+    r.name             = std::string("cow_string/") + sc.name + "/threads:" + std::to_string(threads);
+    r.iterations       = threads * copies;
+    r.ns_per_op        = double(elapsed.count()) / r.iterations;
+    r.items_per_second = elapsed.count() > 0 ? r.iterations * 1e9 / elapsed.count() : 0;
+    return r;
+}
+
+}
+}
+
+void Stress_cow_string(size_t threads = 16, size_t iterations = 20000){
+    my::stress::stress_cow_string(threads, iterations);
+    std::cout << "COW string stress passed\n";
+}
+
+void Bench_cow_refcount(std::ostream& os = std::cout,
+                        size_t max_threads = 64,
+                        size_t copies_per_thread = 200000){
+    const my::stress::scenario scenarios[] = {
+        {"copy_shared",        1, 0},
+        {"copy_private_packed", 0, 0},
+        {"copy_private_padded", 0, 256},
+    };
+    my::bench::runner r;
+    for(const auto& sc : scenarios)
+        for(size_t threads = 1; threads <= max_threads; threads *= 2)
+            r.add(my::stress::measure_copies(sc, threads, copies_per_thread));
+    r.write_json(os, "my::cow_string refcount");
+}
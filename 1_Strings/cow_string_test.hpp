@@ -1,8 +1,11 @@
 #pragma once
 
 #include <cow_string.hpp>
+#include <cow_string_stress.hpp>
+#include <atomic_cow_string.hpp>
 #include <iostream>
 #include <cassert>
+#include <cstdlib>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -106,6 +109,315 @@ void Test_concur(){
 
 }
 
+void Test_refcount_stress(){
+    my::stress::stress_cow_string(8, 5000);
+    my::stress::cow_string empty;
+    my::stress::cow_string copy(empty);
+    assert(copy.references() == 0);
+}
+
+void Test_instrumentation(){
+    auto before = my::instrumentation::collect();
+    my::cow_string str1("Message 1");
+    my::cow_string str2(str1);
+    str2[0] = '}';
+    auto diff = my::instrumentation::collect() - before;
+#ifdef MY_STRING_INSTRUMENTATION
+    assert(diff[my::instrumentation::event::cow_share] == 1);
+    assert(diff[my::instrumentation::event::cow_detach] == 1);
+    assert(diff[my::instrumentation::event::alloc] == 4);
+#else
+    assert(diff[my::instrumentation::event::cow_detach] == 0);
+#endif
+}
+
+void Test_pmr(){
+    char buffer[1024];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof (buffer), std::pmr::null_memory_resource());
+    my::pmr::cow_string str1("Message 1", &arena);
+    my::pmr::cow_string str2(str1, &arena);
+    assert(str1.references() == 2);
+    my::pmr::cow_string str3(str1);
+    assert(str3.references() == 1);
+    assert(str3 == str1);
+    str2[0] = '}';
+    assert(str2 == "}essage 1");
+    assert(str2.get_allocator().resource() == &arena);
+}
+
+void Test_pool(){
+    std::vector<my::pooled::cow_string> strings;
+    strings.reserve(1000);
+    std::thread producer([&strings]{
+        for(int i = 0; i < 1000; ++i) strings.emplace_back("pooled payload");
+    });
+    producer.join();
+    auto before = my::instrumentation::collect();
+    my::pooled::cow_string copy(strings[0]);
+    assert(copy == "pooled payload");
+    assert(copy.references() == 2);
+    strings.clear();
+    for(int i = 0; i < 1000; ++i) strings.emplace_back("pooled payload");
+    assert(strings.back() == copy);
+    auto diff = my::instrumentation::collect() - before;
+    assert(diff[my::instrumentation::event::slab_alloc] == 0);
+}
+
+void Test_pool_orphan(){
+    my::pool_allocator<char> alloc;
+    char* block = nullptr;
+    std::thread owner([&]{ block = alloc.allocate(24); });
+    owner.join();
+    my::pool::slab* s = my::pool::slab::of(block);
+    assert(s->owner.load() == nullptr);
+    std::thread stranger([&]{
+        assert(my::pool::tls_heap() == nullptr);
+        alloc.deallocate(block, 24);
+    });
+    stranger.join();
+    assert(s->remote_free.load() == reinterpret_cast<my::pool::free_node*>(block));
+}
+
+
+void Test_replace(){
+    my::cow_string str("GET /index.html HTTP/1.1");
+    my::cow_string shared(str);
+    str.replace(4, 11, "/home");
+    assert(str == "GET /home HTTP/1.1");
+    assert(shared == "GET /index.html HTTP/1.1");
+    assert(str.capacity() == str.size() + 1);
+    assert(str.references() == 1);
+
+    const char* data = str.c_str();
+    str.replace(0, 3, "PUT");
+    assert(str.c_str() == data);
+    assert(str == "PUT /home HTTP/1.1");
+
+    my::cow_string csv("a;b;c;d");
+    my::cow_string view(csv);
+    assert(csv.replace_all(";", ", ") == 3);
+    assert(csv == "a, b, c, d");
+    assert(csv.capacity() == csv.size() + 1);
+    assert(view == "a;b;c;d");
+
+    data = csv.c_str();
+    assert(csv.replace_all(", ", ",") == 3);
+    assert(csv.c_str() == data);
+    assert(csv == "a,b,c,d");
+    assert(csv.replace_all(",", "--") == 3);
+    assert(csv == "a--b--c--d");
+
+    my::cow_string empty;
+    assert(empty.replace_all("a", "b") == 0);
+    empty.replace(0, 0, "abc");
+    assert(empty == "abc");
+
+    my::cow_string log;
+    size_t moves = 0;
+    for(int i = 0; i < 1000; ++i){
+        const char* prev = log.c_str();
+        log.replace(log.size(), 0, "line\n");
+        if(log.c_str() != prev) moves++;
+    }
+    assert(log.size() == 5000);
+    assert(moves < 16);
+    assert(log.capacity() > log.size() + 1);
+}
+
+void Test_literal(){
+    static const my::cow_string::literal_block hello("hello, world");
+    auto before = my::instrumentation::collect();
+    my::cow_string str(hello);
+    my::cow_string copy(str);
+    {
+        std::vector<my::cow_string> many(100, copy);
+        assert(many[99] == "hello, world");
+    }
+    auto diff = my::instrumentation::collect() - before;
+    assert(diff[my::instrumentation::event::alloc] == 0);
+    assert(str.references() == 1);
+    assert(str.c_str() == copy.c_str());
+
+    copy[0] = 'H';
+    assert(copy == "Hello, world");
+    assert(str == "hello, world");
+    assert(copy.references() == 1);
+    str.push_back('!');
+    assert(str == "hello, world!");
+
+    static const my::pmr::cow_string::literal_block word("static");
+    my::pmr::cow_string pmr(word);
+    assert(pmr == "static");
+}
+
+void Test_adopt(){
+    size_t freed = 0;
+    auto release = [&freed](char* data){
+        std::free(data);
+        freed++;
+    };
+
+    char* payload = static_cast<char*>(std::malloc(32));
+    std::memcpy(payload, "received payload", 16);
+    {
+        auto str = my::cow_string::adopt(payload, 16, 32, release);
+        assert(str.c_str() == payload);
+        assert(str == "received payload");
+        my::cow_string copy(str);
+        assert(copy.c_str() == payload);
+        str[0] = 'R';
+        assert(str.c_str() != payload);
+        assert(copy == "received payload");
+    }
+    assert(freed == 1);
+
+    payload = static_cast<char*>(std::malloc(8));
+    std::memcpy(payload, "abc", 3);
+    {
+        auto str = my::cow_string::adopt(payload, 3, 8, release);
+        str[1] = 'B';
+        assert(str.c_str() == payload);
+        str.push_back('d');
+        assert(str == "aBcd");
+        assert(freed == 2);
+    }
+    assert(freed == 2);
+
+    payload = static_cast<char*>(std::malloc(4));
+    bool thrown = false;
+    try{
+        my::cow_string::adopt(payload, 4, 4, release);
+    }
+    catch(const std::length_error&){
+        thrown = true;
+    }
+    assert(thrown && freed == 3);
+}
+
+void Test_atomic(){
+    my::atomic_cow_string config(my::cow_string("route=v0"));
+    static_assert(my::atomic_cow_string::is_always_lock_free);
+    my::cow_string snapshot = config.load();
+    assert(snapshot == "route=v0");
+    assert(snapshot.references() == 2);
+
+    my::cow_string prev = config.exchange(my::cow_string("route=v1"));
+    assert(prev == "route=v0");
+    assert(prev.c_str() == snapshot.c_str());
+    assert(config.load() == "route=v1");
+
+    my::cow_string expected = snapshot;
+    assert(!config.compare_exchange_strong(expected, my::cow_string("route=v2")));
+    assert(expected == "route=v1");
+    assert(config.compare_exchange_strong(expected, my::cow_string("route=v2")));
+    assert(config.load() == "route=v2");
+
+    const long long blocks_before = my::stress::live().blocks.load();
+    {
+        using stress_string = my::stress::cow_string;
+        const char initial[] = "route=00000";
+        my::atomic_cow_base_string<char, std::char_traits<char>, my::stress::tracking_allocator<char>> shared(stress_string{initial});
+        std::atomic<bool> done{false};
+        my::stress::run_threads(4, [&](size_t tid){
+            if(tid == 0){
+                for(int v = 1; v <= 2000; ++v){
+                    char next[] = "route=00000";
+                    for(int i = 10, x = v; i > 5; --i, x /= 10) next[i] = char('0' + x % 10);
+                    shared.store(stress_string(next));
+                }
+                done.store(true);
+                return;
+            }
+            while(!done.load()){
+                stress_string cur = shared.load();
+                assert(cur.size() == 11);
+                assert(std::strncmp(cur.c_str(), "route=", 6) == 0);
+            }
+        });
+        assert(shared.load() == "route=02000");
+    }
+    assert(my::stress::live().blocks.load() == blocks_before);
+}
+
+#ifdef MY_STRING_TEST_HOOKS
+namespace interleave {
+
+std::mutex m;
+std::condition_variable cv;
+std::thread::id writer;
+int stage = 0;
+
+void advance(int from, int to){
+    std::unique_lock<std::mutex> ul(m);
+    if(stage != from) return;
+    stage = to;
+    cv.notify_all();
+    cv.wait(ul, [to]{ return stage > to; });
+}
+
+void wait_for(int at){
+    std::unique_lock<std::mutex> ul(m);
+    cv.wait(ul, [at]{ return stage >= at; });
+}
+
+void set(int to){
+    std::lock_guard<std::mutex> lg(m);
+    stage = to;
+    cv.notify_all();
+}
+
+void hook(my::test_hooks::step s){
+    const bool on_writer = std::this_thread::get_id() == writer;
+    if(s == my::test_hooks::step::atomic_publishing && on_writer)  advance(0, 1);
+    if(s == my::test_hooks::step::atomic_borrowed   && !on_writer) advance(1, 2);
+}
+
+}
+#endif
+
+void Test_atomic_interleave(){
+#ifdef MY_STRING_TEST_HOOKS
+    using stress_string = my::stress::cow_string;
+    const long long blocks_before = my::stress::live().blocks.load();
+    {
+        my::atomic_cow_base_string<char, std::char_traits<char>, my::stress::tracking_allocator<char>> shared(stress_string{"before"});
+        interleave::writer = std::this_thread::get_id();
+        interleave::stage = 0;
+        my::test_hooks::hook().store(&interleave::hook);
+        std::thread reader([&shared]{
+            interleave::wait_for(1);
+            stress_string cur = shared.load();
+            assert(cur == "before");
+            assert(cur.references() == 1);
+        });
+        shared.store(stress_string("after"));
+        interleave::set(3);
+        reader.join();
+        my::test_hooks::hook().store(nullptr);
+        assert(shared.load() == "after");
+    }
+    assert(my::stress::live().blocks.load() == blocks_before);
+#endif
+}
+
+void Test_wide(){
+    my::cow_base_string<char32_t> u32(U"UTF-32 code units");
+    assert(u32.size() == 17);
+    assert(u32.count(U'e') == 1);
+    assert(u32.count(U't') == 1);
+    assert(u32.cfind(U'3') == std::next(u32.cbegin(), 4));
+
+    my::cow_base_string<char32_t> shared(u32);
+    shared += my::cow_base_string<char32_t>(U" and more");
+    assert(shared.size() == 26);
+    assert(shared == my::cow_base_string<char32_t>(U"UTF-32 code units and more"));
+    assert(u32 == my::cow_base_string<char32_t>(U"UTF-32 code units"));
+
+    const char16_t* text = u"sixteen bit";
+    my::cow_base_string<char16_t> u16(text);
+    assert(u16.size() == std::char_traits<char16_t>::length(text));
+    assert(u16.substr(0, 7) == my::cow_base_string<char16_t>(u"sixteen"));
+}
 
 void Test_cow_string(){
     TestCreate();
@@ -116,5 +428,16 @@ void Test_cow_string(){
     Test_erase_range();
     Test_idx();
     Test_concur();
+    Test_refcount_stress();
+    Test_instrumentation();
+    Test_pmr();
+    Test_pool();
+    Test_pool_orphan();
+    Test_replace();
+    Test_literal();
+    Test_adopt();
+    Test_atomic();
+    Test_atomic_interleave();
+    Test_wide();
     std::cout << "COW string tests passed\n";
 }
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace my {
+
+template<typename CharT,
+         size_t N,
+         typename TraitsT = std::char_traits<CharT>>
+class fixed_string{
+
+    CharT  data_[N + 1] = {};
+    size_t size_ = 0;
+
+public:
+
+    using view_type = std::basic_string_view<CharT, TraitsT>;
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    constexpr fixed_string() = default;
+
+    template<size_t M>
+    constexpr fixed_string(const CharT (&data)[M]){
+        static_assert(M - 1 <= N, "literal does not fit into fixed_string");
+        for(size_t i = 0; i + 1 < M; ++i) data_[i] = data[i];
+        size_ = M - 1;
+    }
+
+    constexpr fixed_string(view_type str){
+        if(str.size() > N) throw std::length_error("fixed_string");
+        for(size_t i = 0; i < str.size(); ++i) data_[i] = str[i];
+        size_ = str.size();
+    }
+
+    static constexpr size_t capacity(){
+        return N;
+    }
+
+    constexpr size_t size() const{
+        return size_;
+    }
+
+    constexpr bool empty() const{
+        return size_ == 0;
+    }
+
+    constexpr const CharT* c_str() const{
+        return data_;
+    }
+
+    constexpr const CharT* begin() const{
+        return data_;
+    }
+
+    constexpr const CharT* end() const{
+        return data_ + size_;
+    }
+
+    constexpr CharT operator[](size_t idx) const{
+        return data_[idx];
+    }
+
+    constexpr view_type view() const{
+        return view_type(data_, size_);
+    }
+
+    constexpr operator view_type() const{
+        return view();
+    }
+
+    constexpr void push_back(CharT c){
+        if(size_ == N) throw std::length_error("fixed_string");
+        data_[size_++] = c;
+    }
+
+    template<size_t M>
+    constexpr fixed_string<CharT, N + M, TraitsT> operator+(const fixed_string<CharT, M, TraitsT>& other) const{
+        fixed_string<CharT, N + M, TraitsT> res(view());
+        for(size_t i = 0; i < other.size(); ++i) res.push_back(other[i]);
+        return res;
+    }
+
+    constexpr size_t find(CharT v, size_t from = 0) const{
+        for(size_t i = from; i < size_; ++i)
+            if(TraitsT::eq(data_[i], v)) return i;
+        return npos;
+    }
+
+    constexpr int compare(view_type other) const{
+        return view().compare(other);
+    }
+
+    template<size_t M>
+    constexpr bool operator==(const fixed_string<CharT, M, TraitsT>& other) const{
+        return compare(other.view()) == 0;
+    }
+
+    template<size_t M>
+    constexpr bool operator!=(const fixed_string<CharT, M, TraitsT>& other) const{
+        return compare(other.view()) != 0;
+    }
+
+    template<size_t M>
+    constexpr bool operator<(const fixed_string<CharT, M, TraitsT>& other) const{
+        return compare(other.view()) < 0;
+    }
+};
+
+template<typename CharT, size_t M>
+fixed_string(const CharT (&)[M]) -> fixed_string<CharT, M - 1>;
+
+template<typename CharT,
+         size_t N,
+         typename TraitsT,
+         size_t K>
+constexpr size_t lookup(const fixed_string<CharT, N, TraitsT> (&table)[K],
+                        typename fixed_string<CharT, N, TraitsT>::view_type key){
+    for(size_t i = 0; i < K; ++i)
+        if(table[i].view() == key) return i;
+    return K;
+}
+
+}
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+#include <utility.hpp>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace my {
+
+template<typename CharT,
+         typename TraitsT = std::char_traits<CharT>>
+class levenshtein{
+
+    using view_type = std::basic_string_view<CharT, TraitsT>;
+    using word      = uint64_t;
+
+    static constexpr size_t bits  = 64;
+    static constexpr word   high  = word(1) << (bits - 1);
+    static constexpr bool   dense = sizeof (CharT) == 1 && std::is_same_v<TraitsT, std::char_traits<CharT>>;
+
+    size_t m_      = 0;
+    size_t blocks_ = 0;
+    word   last_   = 0;
+    std::vector<CharT> keys_;
+    std::vector<word>  peq_;
+
+    size_t row(CharT c) const{
+        if constexpr (dense) return static_cast<unsigned char>(c) * blocks_;
+        else{
+            auto it = std::lower_bound(keys_.begin(), keys_.end(), c, TraitsT::lt);
+            if(it == keys_.end() || !TraitsT::eq(*it, c)) return 0;
+            return (it - keys_.begin() + 1) * blocks_;
+        }
+    }
+
+    const word* eq(CharT c) const{
+        return peq_.data() + row(c);
+    }
+
+    word eq1(CharT c) const{
+        if constexpr (dense) return peq_[static_cast<unsigned char>(c)];
+        else                 return peq_[row(c)];
+    }
+
+    static int step(word& pv, word& mv, word eq, word last, int hin){
+        const word xv = eq | mv;
+        if(hin < 0) eq |= 1;
+        const word xh = (((eq & pv) + pv) ^ pv) | eq;
+        word ph = mv | ~(xh | pv);
+        word mh = pv & xh;
+        const int hout = static_cast<int>((ph & last) != 0) - static_cast<int>((mh & last) != 0);
+        ph <<= 1;
+        mh <<= 1;
+        if(hin < 0)      mh |= 1;
+        else if(hin > 0) ph |= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+        return hout;
+    }
+
+    size_t resume(word pv, word mv, size_t score, view_type text, size_t from, size_t k) const{
+        const size_t n = text.size();
+        for(size_t j = from; j < n; ++j){
+            score += step(pv, mv, eq1(text[j]), last_, 1);
+            if(score > k + (n - j - 1)) return k + 1;
+        }
+        return std::min(score, k + 1);
+    }
+
+    size_t bounded(view_type text, size_t k) const{
+        const size_t n = text.size();
+        if(m_ == 0) return std::min(n, k + 1);
+        if(n > m_ + k || m_ > n + k) return k + 1;
+        if(blocks_ == 1) return resume(~word(0), 0, m_, text, 0, k);
+        std::vector<word> pv(blocks_, ~word(0));
+        std::vector<word> mv(blocks_, 0);
+        size_t score = m_;
+        for(size_t j = 0; j < n; ++j){
+            const word* e = eq(text[j]);
+            int hin = 1;
+            for(size_t b = 0; b < blocks_; ++b) hin = step(pv[b], mv[b], e[b], b + 1 == blocks_ ? last_ : high, hin);
+            score += hin;
+            if(score > k + (n - j - 1)) return k + 1;
+        }
+        return std::min(score, k + 1);
+    }
+
+#if defined(__SSE2__)
+    void bounded_pair(const view_type* texts, size_t* out, size_t k) const{
+        const size_t common = std::min(texts[0].size(), texts[1].size());
+        const __m128i ones  = _mm_set1_epi64x(-1);
+        const __m128i one   = _mm_set1_epi64x(1);
+        const __m128i shift = _mm_cvtsi32_si128(static_cast<int>((m_ - 1) % bits));
+        const CharT* a = texts[0].data();
+        const CharT* b = texts[1].data();
+        __m128i pv    = ones;
+        __m128i mv    = _mm_setzero_si128();
+        __m128i score = _mm_set1_epi64x(static_cast<long long>(m_));
+        for(size_t j = 0; j < common; ++j){
+            const __m128i e  = _mm_set_epi64x(static_cast<long long>(eq1(b[j])), static_cast<long long>(eq1(a[j])));
+            const __m128i xv = _mm_or_si128(e, mv);
+            const __m128i xh = _mm_or_si128(_mm_xor_si128(_mm_add_epi64(_mm_and_si128(e, pv), pv), pv), e);
+            __m128i ph = _mm_or_si128(mv, _mm_andnot_si128(_mm_or_si128(xh, pv), ones));
+            __m128i mh = _mm_and_si128(pv, xh);
+            score = _mm_add_epi64(score, _mm_and_si128(_mm_srl_epi64(ph, shift), one));
+            score = _mm_sub_epi64(score, _mm_and_si128(_mm_srl_epi64(mh, shift), one));
+            ph = _mm_or_si128(_mm_slli_epi64(ph, 1), one);
+            mh = _mm_slli_epi64(mh, 1);
+            pv = _mm_or_si128(mh, _mm_andnot_si128(_mm_or_si128(xv, ph), ones));
+            mv = _mm_and_si128(ph, xv);
+        }
+        word pvs[2], mvs[2], scores[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pvs), pv);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(mvs), mv);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(scores), score);
+        for(size_t l = 0; l < 2; ++l) out[l] = resume(pvs[l], mvs[l], scores[l], texts[l], common, k);
+    }
+#endif
+
+public:
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    template<typename StringT>
+    explicit levenshtein(const StringT& pattern){
+        view_type p = as_view<view_type>(pattern);
+        m_      = p.size();
+        blocks_ = std::max<size_t>(1, (m_ + bits - 1) / bits);
+        last_   = m_ ? word(1) << ((m_ - 1) % bits) : 0;
+        if constexpr (dense){
+            peq_.assign(256 * blocks_, 0);
+        }
+        else{
+            keys_.assign(p.begin(), p.end());
+            std::sort(keys_.begin(), keys_.end(), TraitsT::lt);
+            keys_.erase(std::unique(keys_.begin(), keys_.end(), TraitsT::eq), keys_.end());
+            peq_.assign((keys_.size() + 1) * blocks_, 0);
+        }
+        for(size_t i = 0; i < m_; ++i) peq_[row(p[i]) + i / bits] |= word(1) << (i % bits);
+    }
+
+    size_t size() const{
+        return m_;
+    }
+
+    template<typename StringT>
+    size_t distance(const StringT& str) const{
+        view_type text = as_view<view_type>(str);
+        return bounded(text, m_ + text.size());
+    }
+
+    template<typename StringT>
+    size_t distance(const StringT& str, size_t k) const{
+        return bounded(as_view<view_type>(str), k);
+    }
+
+    template<typename StringT, typename F>
+    void scan(const StringT& str, size_t k, F&& f, size_t from = 0) const{
+        view_type text = as_view<view_type>(str);
+        auto report = [&f](size_t end, size_t score){
+            if constexpr (std::is_void_v<std::invoke_result_t<F&, size_t, size_t>>){
+                f(end, score);
+                return true;
+            }
+            else return static_cast<bool>(f(end, score));
+        };
+        if(from > text.size()) return;
+        if(m_ <= k && !report(from, m_)) return;
+        std::vector<word> pv(blocks_, ~word(0));
+        std::vector<word> mv(blocks_, 0);
+        size_t score = m_;
+        for(size_t j = from; j < text.size(); ++j){
+            const word* e = eq(text[j]);
+            int hin = 0;
+            for(size_t b = 0; b < blocks_; ++b) hin = step(pv[b], mv[b], e[b], b + 1 == blocks_ ? last_ : high, hin);
+            score += hin;
+            if(score <= k && !report(j + 1, score)) return;
+        }
+    }
+
+    template<typename StringT>
+    size_t find(const StringT& str, size_t k, size_t from = 0) const{
+        size_t res = npos;
+        scan(str, k, [&res](size_t end, size_t){
+            res = end;
+            return false;
+        }, from);
+        return res;
+    }
+
+    template<typename Iterator>
+    std::vector<size_t> distances(Iterator first, Iterator last, size_t k) const{
+        std::vector<size_t> res;
+        res.reserve(std::distance(first, last));
+        view_type batch[2];
+        size_t slots[2];
+        size_t pending = 0;
+        for(; first != last; ++first){
+            view_type text = as_view<view_type>(*first);
+            res.push_back(k + 1);
+            if(text.size() > m_ + k || m_ > text.size() + k) continue;
+#if defined(__SSE2__)
+            if(blocks_ == 1 && m_ != 0){
+                batch[pending] = text;
+                slots[pending] = res.size() - 1;
+                if(++pending == 2){
+                    size_t out[2];
+                    bounded_pair(batch, out, k);
+                    res[slots[0]] = out[0];
+                    res[slots[1]] = out[1];
+                    pending = 0;
+                }
+                continue;
+            }
+#endif
+            res.back() = bounded(text, k);
+        }
+        for(size_t l = 0; l < pending; ++l) res[slots[l]] = bounded(batch[l], k);
+        return res;
+    }
+};
+
+template<typename LhsT,
+         typename RhsT>
+size_t edit_distance(const LhsT& lhs, const RhsT& rhs){
+    using view_type = string_view_of_t<LhsT>;
+    view_type a = as_view<view_type>(lhs);
+    view_type b = as_view<view_type>(rhs);
+    if(a.size() > b.size()) std::swap(a, b);
+    return levenshtein<typename view_type::value_type, typename view_type::traits_type>(a).distance(b);
+}
+
+template<typename LhsT,
+         typename RhsT>
+size_t edit_distance(const LhsT& lhs, const RhsT& rhs, size_t k){
+    using view_type = string_view_of_t<LhsT>;
+    view_type a = as_view<view_type>(lhs);
+    view_type b = as_view<view_type>(rhs);
+    if(a.size() > b.size()) std::swap(a, b);
+    return levenshtein<typename view_type::value_type, typename view_type::traits_type>(a).distance(b, k);
+}
+
+template<typename TextT,
+         typename PatternT>
+size_t fuzzy_find(const TextT& text, const PatternT& pattern, size_t k, size_t from = 0){
+    using view_type = string_view_of_t<TextT>;
+    return levenshtein<typename view_type::value_type, typename view_type::traits_type>(as_view<view_type>(pattern)).find(text, k, from);
+}
+
+}
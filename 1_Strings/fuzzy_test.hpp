@@ -0,0 +1,111 @@
+#pragma once
+#include <string.hpp>
+#include <cow_string.hpp>
+#include <fuzzy.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+template<typename CharT>
+size_t naive_edit_distance(std::basic_string_view<CharT> a, std::basic_string_view<CharT> b){
+    std::vector<size_t> row(b.size() + 1);
+    for(size_t j = 0; j <= b.size(); ++j) row[j] = j;
+    for(size_t i = 1; i <= a.size(); ++i){
+        size_t diag = row[0];
+        row[0] = i;
+        for(size_t j = 1; j <= b.size(); ++j){
+            size_t up = row[j];
+            row[j] = std::min({row[j] + 1, row[j - 1] + 1, diag + (a[i - 1] == b[j - 1] ? 0 : 1)});
+            diag = up;
+        }
+    }
+    return row[b.size()];
+}
+
+template<typename CharT>
+size_t naive_fuzzy_end(std::basic_string_view<CharT> text, std::basic_string_view<CharT> pattern, size_t k){
+    for(size_t end = 0; end <= text.size(); ++end)
+        for(size_t begin = 0; begin <= end; ++begin)
+            if(naive_edit_distance(text.substr(begin, end - begin), pattern) <= k) return end;
+    return my::levenshtein<CharT>::npos;
+}
+
+void Test_fuzzy_basic(){
+    assert(my::edit_distance(my::string("kitten"), my::string("sitting")) == 3);
+    assert(my::edit_distance(my::cow_string("flaw"), std::string_view("lawn")) == 2);
+    assert(my::edit_distance(std::string_view(""), std::string_view("abc")) == 3);
+    assert(my::edit_distance(std::string_view("same"), my::cow_string("same")) == 0);
+    assert(my::edit_distance(my::string("kitten"), my::string("sitting"), 2) == 3);
+    assert(my::edit_distance(my::string("kitten"), my::string("sitting"), 5) == 3);
+    assert(my::edit_distance(std::string_view("a"), std::string_view("abcdefgh"), 3) == 4);
+
+    my::levenshtein<char> query(my::string("colour"));
+    assert(query.distance(std::string_view("color")) == 1);
+    assert(query.distance(my::cow_string("flavour"), 1) == 2);
+
+    std::string_view text = "the server responded with a tmieout after 30s";
+    assert(my::fuzzy_find(text, my::string("timeout"), 0) == my::levenshtein<char>::npos);
+    size_t end = my::fuzzy_find(text, my::string("timeout"), 2);
+    assert(end != my::levenshtein<char>::npos && text.substr(end - 7, 7) == "tmieout");
+    assert(my::fuzzy_find(text, std::string_view("server"), 0, 10) == my::levenshtein<char>::npos);
+
+    size_t hits = 0;
+    query.scan(std::string_view("color, colour, colr"), 1, [&hits](size_t, size_t d){
+        assert(d <= 1);
+        hits++;
+    });
+    assert(hits >= 3);
+}
+
+void Test_fuzzy_brute_force(){
+    std::mt19937 gen(11);
+    auto random = [&gen](size_t n, size_t sigma){
+        std::string s;
+        for(size_t i = 0; i < n; ++i) s.push_back(static_cast<char>('a' + gen() % sigma));
+        return s;
+    };
+    for(size_t round = 0; round < 300; ++round){
+        const size_t sigma = 2 + round % 4;
+        std::string a = random(gen() % (round < 200 ? 70 : 300), sigma);
+        std::string b = random(gen() % (round < 200 ? 70 : 300), sigma);
+        const size_t expected = naive_edit_distance<char>(a, b);
+        assert(my::edit_distance(std::string_view(a), std::string_view(b)) == expected);
+        const size_t k = gen() % 20;
+        assert(my::edit_distance(std::string_view(a), std::string_view(b), k) == std::min(expected, k + 1));
+
+        std::u32string wa(a.begin(), a.end());
+        std::u32string wb(b.begin(), b.end());
+        assert(my::edit_distance(std::u32string_view(wa), std::u32string_view(wb)) == expected);
+    }
+    for(size_t round = 0; round < 60; ++round){
+        std::string text    = random(gen() % 40, 3);
+        std::string pattern = random(1 + gen() % (round < 40 ? 6 : 80), 3);
+        const size_t k = gen() % 4;
+        assert(my::fuzzy_find(std::string_view(text), std::string_view(pattern), k) ==
+               naive_fuzzy_end<char>(text, pattern, k));
+    }
+}
+
+void Test_fuzzy_batch(){
+    std::vector<my::string> dictionary{"apple", "apply", "ample", "maple", "applesauce", "", "a", "pineapple", "appel"};
+    for(size_t k = 0; k < 12; ++k){
+        for(std::string_view q : {"appel", "aple", "", "pineapples"}){
+            my::levenshtein<char> query(q);
+            auto res = query.distances(dictionary.begin(), dictionary.end(), k);
+            assert(res.size() == dictionary.size());
+            for(size_t i = 0; i < dictionary.size(); ++i)
+                assert(res[i] == std::min(naive_edit_distance<char>(q, std::string_view(dictionary[i].c_str(), dictionary[i].size())), k + 1));
+        }
+    }
+}
+
+void Test_fuzzy(){
+    Test_fuzzy_basic();
+    Test_fuzzy_brute_force();
+    Test_fuzzy_batch();
+    std::cout << "Fuzzy tests passed\n";
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <ostream>
+
+namespace my {
+namespace instrumentation {
+
+enum class event : size_t{
+    sso_hit,
+    heap_spill,
+    cow_detach,
+    cow_share,
+    deep_copy,
+    alloc,
+    dealloc,
+    slab_alloc,
+    count_
+};
+
+constexpr size_t events       = static_cast<size_t>(event::count_);
+constexpr size_t size_classes = 8;
+
+inline const char* event_name(event e){
+    static const char* names[events] = {
+        "sso_hit", "heap_spill", "cow_detach", "cow_share", "deep_copy", "alloc", "dealloc", "slab_alloc"
+    };
+    return names[static_cast<size_t>(e)];
+}
+
+inline const char* size_class_name(size_t cls){
+    static const char* names[size_classes] = {
+        "16", "32", "64", "256", "1K", "4K", "64K", "inf"
+    };
+    return names[cls];
+}
+
+inline size_t size_class(size_t bytes){
+    static const size_t bounds[size_classes - 1] = {16, 32, 64, 256, 1024, 4096, 65536};
+    return std::lower_bound(bounds, bounds + size_classes - 1, bytes) - bounds;
+}
+
+struct snapshot{
+    uint64_t counts[events]             = {};
+    uint64_t allocs[size_classes]       = {};
+    uint64_t alloc_bytes[size_classes]  = {};
+
+    uint64_t operator[](event e) const{
+        return counts[static_cast<size_t>(e)];
+    }
+
+    uint64_t bytes() const{
+        uint64_t res = 0;
+        for(size_t i = 0; i < size_classes; ++i) res += alloc_bytes[i];
+        return res;
+    }
+
+    snapshot& operator+=(const snapshot& other){
+        for(size_t i = 0; i < events; ++i) counts[i] += other.counts[i];
+        for(size_t i = 0; i < size_classes; ++i){
+            allocs[i]      += other.allocs[i];
+            alloc_bytes[i] += other.alloc_bytes[i];
+        }
+        return *this;
+    }
+
+    snapshot operator-(const snapshot& other) const{
+        snapshot res(*this);
+        for(size_t i = 0; i < events; ++i) res.counts[i] -= other.counts[i];
+        for(size_t i = 0; i < size_classes; ++i){
+            res.allocs[i]      -= other.allocs[i];
+            res.alloc_bytes[i] -= other.alloc_bytes[i];
+        }
+        return res;
+    }
+
+    void write_text(std::ostream& os) const{
+        for(size_t i = 0; i < events; ++i)
+            os << "my_string_events_total{event=\"" << event_name(static_cast<event>(i)) << "\"} " << counts[i] << '\n';
+        for(size_t i = 0; i < size_classes; ++i)
+            os << "my_string_allocs_total{le=\"" << size_class_name(i) << "\"} " << allocs[i] << '\n';
+        for(size_t i = 0; i < size_classes; ++i)
+            os << "my_string_alloc_bytes_total{le=\"" << size_class_name(i) << "\"} " << alloc_bytes[i] << '\n';
+    }
+};
+
+#ifdef MY_STRING_INSTRUMENTATION
+
+struct thread_counters{
+    std::atomic<uint64_t> counts[events]             = {};
+    std::atomic<uint64_t> allocs[size_classes]       = {};
+    std::atomic<uint64_t> alloc_bytes[size_classes]  = {};
+
+    void add_to(snapshot& snap) const{
+        for(size_t i = 0; i < events; ++i) snap.counts[i] += counts[i].load(std::memory_order_relaxed);
+        for(size_t i = 0; i < size_classes; ++i){
+            snap.allocs[i]      += allocs[i].load(std::memory_order_relaxed);
+            snap.alloc_bytes[i] += alloc_bytes[i].load(std::memory_order_relaxed);
+        }
+    }
+};
+
+class registry{
+
+    std::mutex m;
+    std::vector<const thread_counters*> live;
+    snapshot retired;
+
+public:
+
+    static registry& get(){
+        static registry r;
+        return r;
+    }
+
+    void attach(const thread_counters* c){
+        std::lock_guard<std::mutex> lg(m);
+        live.push_back(c);
+    }
+
+    void detach(const thread_counters* c){
+        std::lock_guard<std::mutex> lg(m);
+        c->add_to(retired);
+        live.erase(std::find(live.begin(), live.end(), c));
+    }
+
+    snapshot collect(){
+        std::lock_guard<std::mutex> lg(m);
+        snapshot res = retired;
+        for(const thread_counters* c : live) c->add_to(res);
+        return res;
+    }
+};
+
+struct thread_slot{
+    thread_counters counters;
+
+    thread_slot(){
+        registry::get().attach(&counters);
+    }
+
+    ~thread_slot(){
+        registry::get().detach(&counters);
+    }
+};
+
+inline thread_counters& local(){
+    static thread_local thread_slot slot;
+    return slot.counters;
+}
+
+inline void bump(std::atomic<uint64_t>& c, uint64_t v = 1){
+    c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+}
+
+inline void record(event e){
+    bump(local().counts[static_cast<size_t>(e)]);
+}
+
+inline void record_alloc(size_t bytes){
+    thread_counters& c = local();
+    size_t cls = size_class(bytes);
+    bump(c.counts[static_cast<size_t>(event::alloc)]);
+    bump(c.allocs[cls]);
+    bump(c.alloc_bytes[cls], bytes);
+}
+
+inline snapshot collect(){
+    return registry::get().collect();
+}
+
+#define MY_STRING_RECORD(e)              ::my::instrumentation::record(::my::instrumentation::event::e)
+#define MY_STRING_RECORD_ALLOC(bytes)    ::my::instrumentation::record_alloc(bytes)
+
+#else
+
+inline snapshot collect(){
+    return snapshot();
+}
+
+#define MY_STRING_RECORD(e)              ((void)0)
+#define MY_STRING_RECORD_ALLOC(bytes)    ((void)0)
+
+#endif
+
+}
+}
@@ -15,6 +15,16 @@ class StringIterator : public std::iterator<std::random_access_iterator_tag, T>{
              typename Allocator>
     friend class cow_base_string;
 
+    template<typename CharT,
+             typename TraitsT,
+             typename Allocator>
+    friend class base_string;
+
+    template<typename L,
+             typename R>
+    friend size_t operator-(const StringIterator<L>& lhs,
+                            const StringIterator<R>& rhs);
+
 public:
 
     StringIterator(const StringIterator& it) : data(it.data) {}
@@ -82,13 +92,7 @@ template<typename T,
          typename U>
 size_t operator-(const StringIterator<T>& lhs,
                  const StringIterator<U>& rhs){
-    size_t res = 0;
-    StringIterator curr(lhs);
-    while(curr != rhs){
-        res++;
-        curr = std::prev(curr);
-    }
-    return res;
+    return static_cast<size_t>(lhs.data - rhs.data);
 }
 
 }
@@ -0,0 +1,443 @@
+#pragma once
+
+#include <string_bench.hpp>
+#include <pipeline.hpp>
+#include <search.hpp>
+#include <utility.hpp>
+#include <cmath>
+#include <atomic>
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <charconv>
+#include <iostream>
+#include <stdexcept>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+namespace my {
+namespace bench {
+
+struct splitmix{
+    uint64_t state;
+
+    uint64_t operator()(){
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+};
+
+inline std::string log_corpus(size_t bytes, uint64_t seed, const std::string& dir = ""){
+    namespace fs = std::filesystem;
+    const fs::path path = (dir.empty() ? fs::temp_directory_path() : fs::path(dir)) /
+                          ("my_strings_log_" + std::to_string(seed) + "_" + std::to_string(bytes) + ".log");
+    std::error_code ec;
+    if(fs::exists(path, ec) && fs::file_size(path, ec) >= bytes) return path.string();
+
+    static const char* levels[]  = {"INFO", "INFO", "INFO", "WARN", "ERROR", "DEBUG"};
+    static const char* methods[] = {"GET", "GET", "GET", "POST", "PUT", "DELETE"};
+    static const char* areas[]   = {"items", "users", "orders", "search", "carts", "sessions", "reports", "health"};
+    static const char* statuses[] = {"200", "200", "200", "200", "201", "204", "301", "400", "404", "500", "503"};
+    static const char* words[]   = {"request", "completed", "upstream", "cache", "miss", "hit", "retry", "timeout", "slow", "ok"};
+
+    splitmix rng{seed};
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if(!out) throw std::system_error(errno, std::generic_category(), path.string());
+    std::string chunk;
+    chunk.reserve(size_t(1) << 20);
+    size_t written = 0;
+    uint64_t clock = 1714564800000ull;
+    while(written + chunk.size() < bytes){
+        clock += rng() % 50;
+        const uint64_t r = rng();
+        const uint64_t hot = rng() % 100 < 80 ? rng() % 64 : rng() % 2048;
+        chunk += "ts=";
+        chunk += std::to_string(clock);
+        chunk += " host=web-";
+        chunk += std::to_string(r % 64);
+        chunk += " level=";
+        chunk += levels[(r >> 8) % 6];
+        chunk += " method=";
+        chunk += methods[(r >> 16) % 6];
+        chunk += " path=/api/v";
+        chunk += std::to_string(1 + hot % 3);
+        chunk += '/';
+        chunk += areas[hot % 8];
+        chunk += '/';
+        chunk += std::to_string(hot);
+        chunk += " status=";
+        chunk += statuses[(r >> 24) % 11];
+        chunk += " latency_ms=";
+        chunk += std::to_string((r >> 32) % 2000);
+        chunk += " user=u";
+        chunk += std::to_string((r >> 40) % 100000);
+        chunk += " msg=";
+        for(size_t w = 0, n = 1 + (r >> 60) % 4; w < n; ++w){
+            if(w) chunk += '_';
+            chunk += words[rng() % 10];
+        }
+        chunk += '\n';
+        if(chunk.size() >= (size_t(1) << 20)){
+            out.write(chunk.data(), chunk.size());
+            written += chunk.size();
+            chunk.clear();
+        }
+    }
+    out.write(chunk.data(), chunk.size());
+    if(!out.flush()) throw std::system_error(errno, std::generic_category(), path.string());
+    return path.string();
+}
+
+class latency_histogram{
+
+    static constexpr size_t sub = 32;
+
+    std::vector<uint64_t> buckets_ = std::vector<uint64_t>(64 * sub, 0);
+    uint64_t total_ = 0;
+
+    static size_t bucket(uint64_t ns){
+        if(ns < sub) return ns;
+        const size_t msb = 63 - __builtin_clzll(ns);
+        return (msb - 4) * sub + ((ns >> (msb - 5)) & (sub - 1));
+    }
+
+    static uint64_t lower(size_t idx){
+        if(idx < sub) return idx;
+        const size_t msb = idx / sub + 4;
+        return (uint64_t(1) << msb) | (uint64_t(idx % sub) << (msb - 5));
+    }
+
+public:
+
+    void add(uint64_t ns){
+        buckets_[bucket(ns)]++;
+        total_++;
+    }
+
+    latency_histogram& operator+=(const latency_histogram& other){
+        for(size_t i = 0; i < buckets_.size(); ++i) buckets_[i] += other.buckets_[i];
+        total_ += other.total_;
+        return *this;
+    }
+
+    uint64_t percentile(double p) const{
+        const uint64_t rank = static_cast<uint64_t>(std::ceil(p * total_));
+        uint64_t seen = 0;
+        for(size_t i = 0; i < buckets_.size(); ++i){
+            seen += buckets_[i];
+            if(seen >= rank && buckets_[i]) return lower(i);
+        }
+        return 0;
+    }
+};
+
+inline size_t peak_rss(){
+    std::ifstream status("/proc/self/status");
+    for(std::string line; std::getline(status, line);)
+        if(line.compare(0, 6, "VmHWM:") == 0) return std::stoull(line.substr(6)) * 1024;
+    rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+}
+
+inline void reset_peak_rss(){
+    std::ofstream clear("/proc/self/clear_refs");
+    clear << "5";
+}
+
+struct field_stats{
+    size_t hits    = 0;
+    size_t latency = 0;
+};
+
+struct log_totals{
+    size_t lines   = 0;
+    size_t status  = 0;
+    size_t latency = 0;
+    size_t output  = 0;
+
+    log_totals& operator+=(const log_totals& other){
+        lines   += other.lines;
+        status  += other.status;
+        latency += other.latency;
+        output  += other.output;
+        return *this;
+    }
+
+    bool operator==(const log_totals& other) const{
+        return lines == other.lines && status == other.status && latency == other.latency && output == other.output;
+    }
+};
+
+struct view_hash{
+    template<typename StringT>
+    size_t operator()(const StringT& str) const{
+        return std::hash<std::string_view>()(as_view<std::string_view>(str));
+    }
+};
+
+struct view_equal{
+    template<typename StringT>
+    bool operator()(const StringT& lhs, const StringT& rhs) const{
+        return as_view<std::string_view>(lhs) == as_view<std::string_view>(rhs);
+    }
+};
+
+template<typename StringT>
+struct log_ops;
+
+template<>
+struct log_ops<string>{
+    static std::vector<string> tokens(const string& line){
+        return my::split(line, ' ');
+    }
+    static void append(string& out, std::string_view str){
+        out.replace(out.size(), 0, str);
+    }
+};
+
+template<>
+struct log_ops<cow_string>{
+    static split_arena<char, std::char_traits<char>, counting_allocator<char>> tokens(const cow_string& line){
+        return my::split_into_arena(line, ' ');
+    }
+    static void append(cow_string& out, std::string_view str){
+        out.replace(out.size(), 0, str);
+    }
+};
+
+template<>
+struct log_ops<std_string>{
+    static std::vector<std_string> tokens(const std_string& line){
+        std::vector<std_string> res;
+        res.reserve(std::count(line.begin(), line.end(), ' ') + 1);
+        size_t beg = 0;
+        while(true){
+            size_t end = line.find(' ', beg);
+            if(end == std_string::npos){
+                res.emplace_back(line, beg);
+                return res;
+            }
+            res.emplace_back(line, beg, end - beg);
+            beg = end + 1;
+        }
+    }
+    static void append(std_string& out, std::string_view str){
+        out.append(str.data(), str.size());
+    }
+};
+
+template<typename StringT>
+class log_worker{
+
+    using O   = log_ops<StringT>;
+    using map = std::unordered_map<StringT, field_stats, view_hash, view_equal>;
+
+    static constexpr size_t flush_at = size_t(1) << 16;
+
+    map paths_;
+    map hosts_;
+    StringT out_;
+
+public:
+
+    log_totals totals;
+    latency_histogram latency;
+
+    void line(const char* data, size_t n){
+        const StringT line = ops<StringT>::make(data, n);
+        const auto tokens = O::tokens(line);
+
+        StringT host, path;
+        std::string_view status;
+        size_t ms = 0;
+        for(size_t idx = 0; idx < tokens.size(); ++idx){
+            const std::string_view token = as_view<std::string_view>(tokens[idx]);
+            const char* eq = search::find_char<std::char_traits<char>>(token.data(), token.size(), '=');
+            if(!eq) continue;
+            const std::string_view key(token.data(), eq - token.data());
+            const std::string_view value(eq + 1, token.size() - key.size() - 1);
+            if(key == "host")            host = ops<StringT>::make(value.data(), value.size());
+            else if(key == "path")       path = ops<StringT>::make(value.data(), value.size());
+            else if(key == "status")     status = value;
+            else if(key == "latency_ms") std::from_chars(value.data(), value.data() + value.size(), ms);
+        }
+
+        field_stats& p = paths_[path];
+        p.hits++;
+        p.latency += ms;
+        hosts_[host].hits++;
+
+        O::append(out_, as_view<std::string_view>(host));
+        O::append(out_, " ");
+        O::append(out_, as_view<std::string_view>(path));
+        O::append(out_, " ");
+        O::append(out_, status);
+        O::append(out_, "\n");
+        if(out_.size() >= flush_at){
+            totals.output += out_.size();
+            out_ = StringT();
+        }
+
+        size_t code = 0;
+        std::from_chars(status.data(), status.data() + status.size(), code);
+        totals.lines++;
+        totals.status  += code;
+        totals.latency += ms;
+    }
+
+    void finish(){
+        totals.output += out_.size();
+        out_ = StringT();
+    }
+};
+
+struct log_run{
+    result r;
+    log_totals totals;
+};
+
+template<typename StringT>
+log_run run_log(const std::string& path, size_t threads){
+    using clock = std::chrono::steady_clock;
+
+    std::error_code ec;
+    const size_t bytes = std::filesystem::file_size(path, ec);
+    if(ec) throw std::system_error(ec, path);
+
+    std::vector<log_worker<StringT>> workers(threads);
+    std::vector<alloc_counter> allocs(threads);
+    std::atomic<int> failure{0};
+    reset_peak_rss();
+
+    auto start = clock::now();
+    {
+        std::vector<std::thread> pool;
+        for(size_t t = 0; t < threads; ++t){
+            pool.emplace_back([&, t]{
+                const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if(fd < 0){
+                    failure.store(errno);
+                    return;
+                }
+                const alloc_counter before = counter();
+                const size_t first = bytes * t / threads;
+                const size_t last  = bytes * (t + 1) / threads;
+                std::vector<char> block(size_t(1) << 20);
+                auto process = [&](const char* data, size_t n){
+                    auto line_start = clock::now();
+                    workers[t].line(data, n);
+                    workers[t].latency.add(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - line_start).count());
+                };
+                size_t pos  = t == 0 ? 0 : first - 1;
+                size_t kept = 0;
+                bool skip   = t != 0;
+                while(true){
+                    const ssize_t got = ::pread(fd, block.data() + kept, block.size() - kept, pos);
+                    const size_t base = pos - kept;
+                    if(got < 0) failure.store(errno);
+                    if(got <= 0){
+                        if(kept && !skip && base < last) process(block.data(), kept);
+                        break;
+                    }
+                    const size_t end = kept + got;
+                    pos += got;
+                    size_t beg = 0;
+                    bool done = false;
+                    for(const char* nl; (nl = search::find_char<std::char_traits<char>>(block.data() + beg, end - beg, '\n'));){
+                        const size_t stop = nl - block.data();
+                        if(skip)                     skip = false;
+                        else if(base + beg >= last)  done = true;
+                        else                         process(block.data() + beg, stop - beg);
+                        if(done) break;
+                        beg = stop + 1;
+                    }
+                    if(done || base + beg >= last) break;
+                    kept = end - beg;
+                    std::memmove(block.data(), block.data() + beg, kept);
+                    if(kept == block.size()) block.resize(2 * block.size());
+                }
+                workers[t].finish();
+                const alloc_counter after = counter();
+                allocs[t].allocs = after.allocs - before.allocs;
+                allocs[t].bytes  = after.bytes - before.bytes;
+                ::close(fd);
+            });
+        }
+        for(auto& th : pool) th.join();
+    }
+    if(failure.load()) throw std::system_error(failure.load(), std::generic_category(), path);
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start);
+
+    log_run run;
+    latency_histogram latency;
+    alloc_counter total_allocs;
+    for(size_t t = 0; t < threads; ++t){
+        run.totals += workers[t].totals;
+        latency += workers[t].latency;
+        total_allocs.allocs += allocs[t].allocs;
+        total_allocs.bytes  += allocs[t].bytes;
+    }
+    const size_t lines = std::max<size_t>(1, run.totals.lines);
+    run.r.name               = std::string("log/") + ops<StringT>::name() + "/threads:" + std::to_string(threads);
+    run.r.iterations         = run.totals.lines;
+    run.r.ns_per_op          = double(elapsed.count()) / lines;
+    run.r.bytes_per_second   = elapsed.count() > 0 ? bytes * 1e9 / elapsed.count() : 0;
+    run.r.items_per_second   = elapsed.count() > 0 ? run.totals.lines * 1e9 / elapsed.count() : 0;
+    run.r.allocs_per_op      = double(total_allocs.allocs) / lines;
+    run.r.bytes_alloc_per_op = double(total_allocs.bytes) / lines;
+    run.r.p50_ns             = latency.percentile(0.50);
+    run.r.p99_ns             = latency.percentile(0.99);
+    run.r.peak_rss_bytes     = peak_rss();
+    return run;
+}
+
+}
+}
+
+void Bench_log(const std::string& path = "",
+               std::ostream& os = std::cout,
+               size_t bytes = size_t(2) << 30,
+               size_t threads = my::pipeline::workers::hardware(),
+               uint64_t seed = 42){
+    const std::string corpus = path.empty() ? my::bench::log_corpus(bytes, seed) : path;
+
+    my::bench::runner r;
+    std::vector<my::bench::log_run> runs;
+    for(size_t t = 1; ; t = std::min(2 * t, threads)){
+        runs.push_back(my::bench::run_log<my::bench::std_string>(corpus, t));
+        runs.push_back(my::bench::run_log<my::bench::string>(corpus, t));
+        runs.push_back(my::bench::run_log<my::bench::cow_string>(corpus, t));
+        if(t >= threads) break;
+    }
+
+    double log_sum = 0;
+    size_t scored = 0;
+    for(const auto& run : runs){
+        if(!(run.totals == runs.front().totals)) throw std::logic_error("Bench_log: backends disagree on " + run.r.name);
+        r.add(run.r);
+        if(run.r.name.compare(0, 8, "log/std_") != 0 && run.r.bytes_per_second > 0){
+            log_sum += std::log(run.r.bytes_per_second);
+            scored++;
+        }
+    }
+    my::bench::result score;
+    score.name             = "log/score";
+    score.iterations       = scored;
+    score.bytes_per_second = scored ? std::exp(log_sum / scored) : 0;
+    r.add(score);
+    r.write_json(os, "my::string,my::cow_string,std::string");
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <system_error>
+
+namespace my {
+namespace numeric {
+
+template<typename T>
+constexpr size_t max_chars = std::is_floating_point_v<T> ? std::numeric_limits<T>::max_digits10 + 12
+                                                         : std::numeric_limits<T>::digits10 + 3;
+
+template<typename T>
+size_t digits(T value){
+    using U = std::make_unsigned_t<T>;
+    U v = static_cast<U>(value);
+    size_t n = 1;
+    if constexpr (std::is_signed_v<T>){
+        if(value < 0){
+            v = U(0) - v;
+            n++;
+        }
+    }
+    for(; v >= 10000; v /= 10000) n += 4;
+    if(v >= 10)   n++;
+    if(v >= 100)  n++;
+    if(v >= 1000) n++;
+    return n;
+}
+
+template<typename CharT, typename T>
+size_t format(CharT* out, size_t n, T value){
+    if constexpr (sizeof (CharT) == 1){
+        char* first = reinterpret_cast<char*>(out);
+        std::to_chars_result res = std::to_chars(first, first + n, value);
+        if(res.ec != std::errc()) throw std::length_error("numeric::format");
+        return res.ptr - first;
+    }
+    else{
+        char buf[max_chars<T>];
+        size_t len = format(buf, sizeof (buf), value);
+        if(len > n) throw std::length_error("numeric::format");
+        for(size_t i = 0; i < len; ++i) out[i] = static_cast<CharT>(buf[i]);
+        return len;
+    }
+}
+
+template<typename T, typename CharT>
+bool parse(const CharT* data, size_t n, T& value, std::errc& ec){
+    if constexpr (sizeof (CharT) == 1){
+        const char* first = reinterpret_cast<const char*>(data);
+        std::from_chars_result res = std::from_chars(first, first + n, value);
+        ec = res.ec;
+        if(ec == std::errc() && res.ptr != first + n) ec = std::errc::invalid_argument;
+        return ec == std::errc();
+    }
+    else{
+        char buf[64];
+        ec = std::errc::invalid_argument;
+        if(n > sizeof (buf)) return false;
+        for(size_t i = 0; i < n; ++i){
+            if(static_cast<uint32_t>(data[i]) > 0x7F) return false;
+            buf[i] = static_cast<char>(data[i]);
+        }
+        return parse(buf, n, value, ec);
+    }
+}
+
+template<typename T, typename CharT>
+bool parse(const CharT* data, size_t n, T& value){
+    std::errc ec;
+    return parse(data, n, value, ec);
+}
+
+template<typename T, typename CharT>
+T to_number(const CharT* data, size_t n){
+    T value{};
+    std::errc ec;
+    if(!parse(data, n, value, ec)){
+        if(ec == std::errc::result_out_of_range) throw std::out_of_range("to_number");
+        throw std::invalid_argument("to_number");
+    }
+    return value;
+}
+
+}
+
+template<typename T,
+         typename CharT,
+         typename TraitsT>
+T to_number(std::basic_string_view<CharT, TraitsT> view){
+    return numeric::to_number<T>(view.data(), view.size());
+}
+
+}
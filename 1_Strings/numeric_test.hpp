@@ -0,0 +1,96 @@
+#pragma once
+#include <string.hpp>
+#include <cow_string.hpp>
+#include <utility.hpp>
+#include <numeric.hpp>
+#include <limits>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <stdexcept>
+#include <iostream>
+
+void Test_numeric_digits(){
+    assert(my::numeric::digits(0) == 1);
+    assert(my::numeric::digits(9) == 1);
+    assert(my::numeric::digits(10) == 2);
+    assert(my::numeric::digits(-10) == 3);
+    assert(my::numeric::digits(99999) == 5);
+    assert(my::numeric::digits(std::numeric_limits<int64_t>::min()) == 20);
+    assert(my::numeric::digits(std::numeric_limits<uint64_t>::max()) == 20);
+}
+
+void Test_numeric_append(){
+    my::string str("id=");
+    str.append_int(42);
+    assert(str == my::string("id=42"));
+    str.append_int(std::numeric_limits<int64_t>::min());
+    assert(std::strcmp(str.c_str(), "id=42-9223372036854775808") == 0);
+
+    my::string small;
+    small.append_int(7u);
+    assert(std::strcmp(small.c_str(), "7") == 0);
+
+    my::cow_string line("t=");
+    line.append_double(0.1);
+    assert(line == "t=0.1");
+    line.append_int(-5);
+    assert(line == "t=0.1-5");
+
+    my::cow_string shared(line);
+    shared.append_int(0);
+    assert(shared == "t=0.1-50");
+    assert(line == "t=0.1-5");
+
+    my::cow_string many;
+    for(int i = 0; i < 1000; ++i) many.append_int(i % 10);
+    assert(many.size() == 1000);
+    assert(many[999] == '9');
+
+    my::base_string<char16_t> wide(u"n=");
+    wide.append_int(123);
+    assert(wide == my::base_string<char16_t>(u"n=123"));
+}
+
+void Test_numeric_parse(){
+    assert(my::string("12345").to_number<int>() == 12345);
+    assert(my::cow_string("-17").to_number<long>() == -17);
+    assert(my::cow_string("2.5").to_number<double>() == 2.5);
+    assert(my::to_number<unsigned>(std::string_view("4096")) == 4096);
+
+    bool thrown = false;
+    try{ my::string("12x").to_number<int>(); }
+    catch(const std::invalid_argument&){ thrown = true; }
+    assert(thrown);
+
+    thrown = false;
+    try{ my::cow_string("300").to_number<uint8_t>(); }
+    catch(const std::out_of_range&){ thrown = true; }
+    assert(thrown);
+
+    thrown = false;
+    try{ my::cow_string().to_number<int>(); }
+    catch(const std::invalid_argument&){ thrown = true; }
+    assert(thrown);
+
+    int value = 0;
+    assert(!my::numeric::parse("", 0, value));
+    assert(my::numeric::parse(u"65535", 5, value) && value == 65535);
+
+    long sum = 0;
+    for(const auto& token : my::split(my::cow_string("10,20,30,-5"), ',')) sum += token.to_number<long>();
+    assert(sum == 55);
+
+    double d = 0.0;
+    my::cow_string round;
+    round.append_double(1.0 / 3.0);
+    assert(my::numeric::parse(round.c_str(), round.size(), d) && d == 1.0 / 3.0);
+}
+
+void Test_numeric(){
+    Test_numeric_digits();
+    Test_numeric_append();
+    Test_numeric_parse();
+    std::cout << "Numeric tests passed\n";
+}
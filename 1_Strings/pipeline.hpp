@@ -0,0 +1,353 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cow_string.hpp>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace my {
+namespace pipeline {
+
+constexpr size_t cache_line = 64;
+
+class backoff{
+
+    unsigned spins = 0;
+
+public:
+
+    void pause(){
+        if(spins < 64){
+            spins++;
+#if defined(__SSE2__)
+            _mm_pause();
+#endif
+        }
+        else{
+            std::this_thread::yield();
+        }
+    }
+
+    void reset(){
+        spins = 0;
+    }
+};
+
+template<typename T>
+class mpmc_ring{
+
+    struct alignas(cache_line) slot{
+        std::atomic<size_t> seq{0};
+        T value{};
+    };
+
+    std::unique_ptr<slot[]> slots_;
+    size_t mask_;
+
+    alignas(cache_line) std::atomic<size_t> head_{0};
+    alignas(cache_line) std::atomic<size_t> tail_{0};
+    alignas(cache_line) std::atomic<bool>   closed_{false};
+
+    static size_t round_up(size_t n){
+        size_t res = 2;
+        while(res < n) res <<= 1;
+        return res;
+    }
+
+public:
+
+    explicit mpmc_ring(size_t capacity) : slots_(new slot[round_up(capacity)]), mask_(round_up(capacity) - 1){
+        for(size_t i = 0; i <= mask_; ++i) slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    mpmc_ring(const mpmc_ring&) = delete;
+    mpmc_ring& operator=(const mpmc_ring&) = delete;
+
+    size_t capacity() const{
+        return mask_ + 1;
+    }
+
+    bool try_push(T& value){
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        while(true){
+            slot& s = slots_[pos & mask_];
+            size_t seq = s.seq.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if(dif == 0){
+                if(tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                    s.value = std::move(value);
+                    s.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if(dif < 0){
+                return false;
+            }
+            else{
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T& value){
+        size_t pos = head_.load(std::memory_order_relaxed);
+        while(true){
+            slot& s = slots_[pos & mask_];
+            size_t seq = s.seq.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if(dif == 0){
+                if(head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                    value = std::move(s.value);
+                    s.seq.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if(dif < 0){
+                return false;
+            }
+            else{
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void push(T value){
+        backoff b;
+        while(!try_push(value)) b.pause();
+    }
+
+    bool pop(T& value){
+        backoff b;
+        while(!try_pop(value)){
+            if(closed_.load(std::memory_order_acquire)) return try_pop(value);
+            b.pause();
+        }
+        return true;
+    }
+
+    void close(){
+        closed_.store(true, std::memory_order_release);
+    }
+
+    bool closed() const{
+        return closed_.load(std::memory_order_acquire);
+    }
+};
+
+template<typename CharT,
+         typename TraitsT = std::char_traits<CharT>,
+         typename Allocator = std::allocator<CharT>,
+         size_t Batch = 16>
+class cow_channel{
+
+public:
+
+    using string_type = cow_base_string<CharT, TraitsT, Allocator>;
+
+private:
+
+    using handle = typename string_type::ControlBlock*;
+
+    struct batch{
+        handle items[Batch] = {};
+        size_t count = 0;
+    };
+
+    mpmc_ring<batch> ring_;
+    Allocator alloc_;
+
+    static handle take(string_type&& str){
+        handle h = str.info;
+        str.info = nullptr;
+        return h;
+    }
+
+    string_type adopt(handle h) const{
+        string_type res(alloc_);
+        res.info = h;
+        return res;
+    }
+
+    void drop(batch& b, size_t from) const{
+        for(size_t i = from; i < b.count; ++i) adopt(b.items[i]);
+        b.count = 0;
+    }
+
+public:
+
+    class producer{
+
+        cow_channel* channel_;
+        batch local_;
+
+    public:
+
+        explicit producer(cow_channel& channel) : channel_(&channel) {}
+
+        producer(const producer&) = delete;
+        producer& operator=(const producer&) = delete;
+
+        ~producer(){
+            flush();
+        }
+
+        void push(string_type str){
+            local_.items[local_.count++] = take(std::move(str));
+            if(local_.count == Batch) flush();
+        }
+
+        void flush(){
+            if(local_.count == 0) return;
+            channel_->ring_.push(local_);
+            local_.count = 0;
+        }
+    };
+
+    class consumer{
+
+        cow_channel* channel_;
+        batch local_;
+        size_t next_ = 0;
+
+    public:
+
+        explicit consumer(cow_channel& channel) : channel_(&channel) {}
+
+        consumer(const consumer&) = delete;
+        consumer& operator=(const consumer&) = delete;
+
+        ~consumer(){
+            channel_->drop(local_, next_);
+        }
+
+        bool pop(string_type& out){
+            if(next_ == local_.count){
+                next_ = 0;
+                local_.count = 0;
+                if(!channel_->ring_.pop(local_)) return false;
+            }
+            out = channel_->adopt(local_.items[next_++]);
+            return true;
+        }
+    };
+
+    explicit cow_channel(size_t batches = 1024, const Allocator& alloc = Allocator())
+        : ring_(batches), alloc_(alloc) {}
+
+    ~cow_channel(){
+        batch b;
+        while(ring_.try_pop(b)) drop(b, 0);
+    }
+
+    static constexpr size_t batch_size(){
+        return Batch;
+    }
+
+    size_t capacity() const{
+        return ring_.capacity() * Batch;
+    }
+
+    void push(string_type str){
+        batch b;
+        b.items[b.count++] = take(std::move(str));
+        ring_.push(b);
+    }
+
+    template<typename InputIt>
+    void push(InputIt beg, InputIt end){
+        batch b;
+        for(; beg != end; ++beg){
+            b.items[b.count++] = take(std::move(*beg));
+            if(b.count == Batch){
+                ring_.push(b);
+                b.count = 0;
+            }
+        }
+        if(b.count) ring_.push(b);
+    }
+
+    producer make_producer(){
+        return producer(*this);
+    }
+
+    void close(){
+        ring_.close();
+    }
+
+    bool closed() const{
+        return ring_.closed();
+    }
+};
+
+class workers{
+
+    std::vector<std::thread> threads_;
+
+public:
+
+    workers() = default;
+    workers(const workers&) = delete;
+    workers& operator=(const workers&) = delete;
+
+    ~workers(){
+        join();
+    }
+
+    static size_t hardware(){
+        size_t n = std::thread::hardware_concurrency();
+        return n ? n : 1;
+    }
+
+    template<typename F>
+    void spawn(size_t n, F body){
+        for(size_t id = 0; id < n; ++id) threads_.emplace_back(body, id);
+    }
+
+    void join(){
+        for(auto& th : threads_) if(th.joinable()) th.join();
+        threads_.clear();
+    }
+};
+
+template<typename OutChannel, typename F>
+void spawn_source(workers& pool, OutChannel& out, F body){
+    pool.spawn(1, [&out, body](size_t) mutable{
+        {
+            typename OutChannel::producer prod(out);
+            body(prod);
+        }
+        out.close();
+    });
+}
+
+template<typename InChannel, typename OutChannel, typename F>
+void spawn_stage(workers& pool, size_t n, InChannel& in, OutChannel& out, F body){
+    auto remaining = std::make_shared<std::atomic<size_t>>(n);
+    pool.spawn(n, [&in, &out, body, remaining](size_t id) mutable{
+        {
+            typename InChannel::consumer cons(in);
+            typename OutChannel::producer prod(out);
+            typename InChannel::string_type item;
+            while(cons.pop(item)) body(std::move(item), prod, id);
+        }
+        if(remaining->fetch_sub(1, std::memory_order_acq_rel) == 1) out.close();
+    });
+}
+
+template<typename InChannel, typename F>
+void spawn_sink(workers& pool, size_t n, InChannel& in, F body){
+    pool.spawn(n, [&in, body](size_t id) mutable{
+        typename InChannel::consumer cons(in);
+        typename InChannel::string_type item;
+        while(cons.pop(item)) body(std::move(item), id);
+    });
+}
+
+}
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <pipeline.hpp>
+#include <string_bench.hpp>
+#include <utility.hpp>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <fstream>
+#include <iostream>
+
+namespace my {
+namespace bench {
+
+template<typename StringT>
+class locked_channel{
+
+    std::mutex m_;
+    std::deque<StringT> items_;
+    bool closed_ = false;
+
+public:
+
+    using string_type = StringT;
+
+    class producer{
+
+        locked_channel* channel_;
+
+    public:
+
+        explicit producer(locked_channel& channel) : channel_(&channel) {}
+
+        void push(StringT str){
+            std::lock_guard<std::mutex> lg(channel_->m_);
+            channel_->items_.push_back(std::move(str));
+        }
+    };
+
+    class consumer{
+
+        locked_channel* channel_;
+
+    public:
+
+        explicit consumer(locked_channel& channel) : channel_(&channel) {}
+
+        bool pop(StringT& out){
+            pipeline::backoff b;
+            while(true){
+                {
+                    std::lock_guard<std::mutex> lg(channel_->m_);
+                    if(!channel_->items_.empty()){
+                        out = std::move(channel_->items_.front());
+                        channel_->items_.pop_front();
+                        return true;
+                    }
+                    if(channel_->closed_) return false;
+                }
+                b.pause();
+            }
+        }
+    };
+
+    void close(){
+        std::lock_guard<std::mutex> lg(m_);
+        closed_ = true;
+    }
+};
+
+struct alignas(pipeline::cache_line) pipeline_counter{
+    size_t tokens = 0;
+    size_t bytes  = 0;
+};
+
+template<typename LineChannel, typename TokenChannel>
+result run_pipeline(const std::string& name, const std::vector<std::string>& lines, size_t threads){
+    using string_type = typename LineChannel::string_type;
+
+    LineChannel  line_channel;
+    TokenChannel token_channel;
+    std::vector<pipeline_counter> counters(threads);
+    size_t input_bytes = 0;
+    for(const auto& line : lines) input_bytes += line.size();
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        pipeline::workers pool;
+        pipeline::spawn_source(pool, line_channel, [&lines](auto& out){
+            for(const auto& line : lines) out.push(string_type(line.data(), line.size()));
+        });
+        pipeline::spawn_stage(pool, threads, line_channel, token_channel, [](string_type line, auto& out, size_t){
+            for(auto& token : my::split(line, ' ')) out.push(std::move(token));
+        });
+        pipeline::spawn_sink(pool, threads, token_channel, [&counters](string_type token, size_t id){
+            counters[id].tokens++;
+            counters[id].bytes += token.size();
+        });
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    size_t tokens = 0;
+    for(const auto& c : counters) tokens += c.tokens;
+
+    result r;
+    r.name             = name + "/threads:" + std::to_string(threads);
+    r.iterations       = lines.size();
+    r.ns_per_op        = double(elapsed.count()) / std::max<size_t>(1, lines.size());
+    r.bytes_per_second = elapsed.count() > 0 ? input_bytes * 1e9 / elapsed.count() : 0;
+    r.items_per_second = elapsed.count() > 0 ? tokens * 1e9 / elapsed.count() : 0;
+    return r;
+}
+
+inline std::vector<std::string> read_lines(const std::string& path){
+    std::vector<std::string> lines;
+    std::ifstream in(path);
+    for(std::string line; std::getline(in, line);) lines.push_back(std::move(line));
+    return lines;
+}
+
+inline std::vector<std::string> synthetic_lines(size_t n){
+    std::vector<std::string> lines;
+    lines.reserve(n);
+    for(size_t i = 0; i < n; ++i)
+        lines.push_back("2024-05-01T12:00:00Z host-" + std::to_string(i % 64) +
+                        " GET /api/v1/items/" + std::to_string(i) + " 200 " + std::to_string(i % 1000) + "ms");
+    return lines;
+}
+
+}
+}
+
+void Bench_pipeline(const std::string& path = "",
+                    std::ostream& os = std::cout,
+                    size_t threads = my::pipeline::workers::hardware()){
+    using cow_string = my::cow_string;
+    std::vector<std::string> lines = path.empty() ? my::bench::synthetic_lines(200000) : my::bench::read_lines(path);
+
+    my::bench::runner r;
+    for(size_t t = 1; t <= threads; t *= 2){
+        r.add(my::bench::run_pipeline<my::pipeline::cow_channel<char>, my::pipeline::cow_channel<char>>("pipeline/cow_channel", lines, t));
+        r.add(my::bench::run_pipeline<my::bench::locked_channel<cow_string>, my::bench::locked_channel<cow_string>>("pipeline/mutex_queue", lines, t));
+    }
+    r.write_json(os, "my::pipeline");
+}
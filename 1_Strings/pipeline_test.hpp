@@ -0,0 +1,82 @@
+#pragma once
+#include <pipeline.hpp>
+#include <cow_string_stress.hpp>
+#include <utility.hpp>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <iostream>
+
+void Test_ring(){
+    my::pipeline::mpmc_ring<int> ring(3);
+    assert(ring.capacity() == 4);
+    for(int i = 0; i < 4; ++i){
+        int v = i;
+        assert(ring.try_push(v));
+    }
+    int extra = 4;
+    assert(!ring.try_push(extra));
+    for(int i = 0; i < 4; ++i){
+        int v = -1;
+        assert(ring.try_pop(v) && v == i);
+    }
+    int v = -1;
+    assert(!ring.try_pop(v));
+    ring.close();
+    assert(!ring.pop(v));
+}
+
+void Test_channel_handoff(){
+    my::pipeline::cow_channel<char> channel(4);
+    my::cow_string payload("handed over without refcount traffic");
+    const char* data = payload.c_str();
+    channel.push(std::move(payload));
+    {
+        auto prod = channel.make_producer();
+        for(int i = 0; i < 20; ++i) prod.push(my::cow_string("batched"));
+    }
+    channel.close();
+
+    my::pipeline::cow_channel<char>::consumer cons(channel);
+    my::cow_string out;
+    assert(cons.pop(out));
+    assert(out.c_str() == data);
+    assert(out.references() == 1);
+    size_t batched = 0;
+    while(cons.pop(out)){
+        assert(out == "batched");
+        batched++;
+    }
+    assert(batched == 20);
+}
+
+void Test_pipeline_stages(){
+    using stress_string = my::stress::cow_string;
+    using channel = my::pipeline::cow_channel<char, std::char_traits<char>, my::stress::tracking_allocator<char>, 8>;
+    const long long blocks_before = my::stress::live().blocks.load();
+    std::atomic<size_t> tokens{0};
+    {
+        channel lines(2);
+        channel words(2);
+        my::pipeline::workers pool;
+        my::pipeline::spawn_source(pool, lines, [](channel::producer& out){
+            for(int i = 0; i < 500; ++i) out.push(stress_string("one two three four"));
+        });
+        my::pipeline::spawn_stage(pool, 3, lines, words, [](stress_string line, channel::producer& out, size_t){
+            for(auto& word : my::split(line, ' ')) out.push(std::move(word));
+        });
+        my::pipeline::spawn_sink(pool, 2, words, [&tokens](stress_string word, size_t){
+            assert(word.size() >= 3);
+            tokens.fetch_add(1);
+        });
+    }
+    assert(tokens.load() == 2000);
+    assert(my::stress::live().blocks.load() == blocks_before);
+}
+
+void Test_pipeline(){
+    Test_ring();
+    Test_channel_handoff();
+    Test_pipeline_stages();
+    std::cout << "Pipeline tests passed\n";
+}
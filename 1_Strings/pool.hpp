@@ -0,0 +1,292 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <cstdint>
+#include <cstddef>
+#include <instrumentation.hpp>
+
+namespace my {
+namespace pool {
+
+constexpr size_t slab_size   = 64 * 1024;
+constexpr size_t granularity = 16;
+constexpr size_t max_block   = 256;
+constexpr size_t classes     = max_block / granularity;
+
+inline size_t class_of(size_t bytes){
+    return (bytes + granularity - 1) / granularity - 1;
+}
+
+struct free_node{
+    free_node* next;
+};
+
+class heap;
+
+struct alignas(64) slab{
+    std::atomic<heap*>      owner;
+    std::atomic<free_node*> remote_free{nullptr};
+    free_node* local_free = nullptr;
+    char*  bump;
+    char*  end;
+    size_t block_size;
+    slab*  next = nullptr;
+
+    slab(heap* h, size_t block) : owner(h), block_size(block){
+        bump = reinterpret_cast<char*>(this) + sizeof (slab);
+        end  = reinterpret_cast<char*>(this) + slab_size;
+    }
+
+    static slab* of(void* p){
+        return reinterpret_cast<slab*>(reinterpret_cast<uintptr_t>(p) & ~(uintptr_t(slab_size) - 1));
+    }
+
+    static slab* make(heap* h, size_t block){
+        MY_STRING_RECORD(slab_alloc);
+        void* mem = ::operator new(slab_size, std::align_val_t(slab_size));
+        return ::new (mem) slab(h, block);
+    }
+
+    static void destroy(slab* s){
+        s->~slab();
+        ::operator delete(static_cast<void*>(s), std::align_val_t(slab_size));
+    }
+
+    size_t capacity() const{
+        return (slab_size - sizeof (slab)) / block_size;
+    }
+
+    void push_local(void* p){
+        free_node* node = static_cast<free_node*>(p);
+        node->next = local_free;
+        local_free = node;
+    }
+
+    void push_remote(void* p){
+        free_node* node = static_cast<free_node*>(p);
+        free_node* head = remote_free.load(std::memory_order_relaxed);
+        do{
+            node->next = head;
+        } while(!remote_free.compare_exchange_weak(head, node,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed));
+    }
+
+    bool collect(){
+        free_node* list = remote_free.exchange(nullptr, std::memory_order_acquire);
+        if(!list) return false;
+        free_node* tail = list;
+        while(tail->next) tail = tail->next;
+        tail->next = local_free;
+        local_free = list;
+        return true;
+    }
+
+    void* pop(){
+        if(!local_free && bump + block_size > end) collect();
+        if(local_free){
+            free_node* node = local_free;
+            local_free = node->next;
+            return node;
+        }
+        if(bump + block_size <= end){
+            void* p = bump;
+            bump += block_size;
+            return p;
+        }
+        return nullptr;
+    }
+
+    size_t free_blocks() const{
+        size_t res = (end - bump) / block_size;
+        for(free_node* node = local_free; node; node = node->next) res++;
+        return res;
+    }
+};
+
+class orphanage{
+
+    std::mutex m;
+    slab* lists[classes] = {};
+
+public:
+
+    static orphanage& get(){
+        static orphanage* o = new orphanage();
+        return *o;
+    }
+
+    void push(size_t cls, slab* s){
+        std::lock_guard<std::mutex> lg(m);
+        s->next = lists[cls];
+        lists[cls] = s;
+    }
+
+    slab* pop(size_t cls){
+        std::lock_guard<std::mutex> lg(m);
+        slab* s = lists[cls];
+        if(s) lists[cls] = s->next;
+        return s;
+    }
+};
+
+class heap{
+
+    slab* slabs[classes] = {};
+
+    slab* refill(size_t cls){
+        for(slab* s = slabs[cls]; s; s = s->next)
+            if(s->local_free || s->bump + s->block_size <= s->end || s->collect()) return s;
+
+        slab* s = orphanage::get().pop(cls);
+        if(s) s->owner.store(this, std::memory_order_relaxed);
+        else  s = slab::make(this, (cls + 1) * granularity);
+        s->next = slabs[cls];
+        slabs[cls] = s;
+        return s;
+    }
+
+public:
+
+    heap() = default;
+    heap(const heap&) = delete;
+    heap& operator=(const heap&) = delete;
+
+    ~heap(){
+        for(size_t cls = 0; cls < classes; ++cls){
+            slab* s = slabs[cls];
+            while(s){
+                slab* next = s->next;
+                s->collect();
+                if(s->free_blocks() == s->capacity()){
+                    slab::destroy(s);
+                }
+                else{
+                    s->owner.store(nullptr, std::memory_order_release);
+                    orphanage::get().push(cls, s);
+                }
+                s = next;
+            }
+        }
+    }
+
+    void* allocate(size_t cls){
+        slab* s = slabs[cls];
+        void* p = s ? s->pop() : nullptr;
+        if(!p){
+            s = refill(cls);
+            if(s != slabs[cls]){
+                slab** link = &slabs[cls];
+                while(*link != s) link = &(*link)->next;
+                *link = s->next;
+                s->next = slabs[cls];
+                slabs[cls] = s;
+            }
+            p = s->pop();
+        }
+        return p;
+    }
+};
+
+inline heap* dead_heap(){
+    return reinterpret_cast<heap*>(uintptr_t(1));
+}
+
+inline heap*& tls_heap(){
+    static thread_local heap* h = nullptr;
+    return h;
+}
+
+struct heap_guard{
+    ~heap_guard(){
+        heap* h = tls_heap();
+        tls_heap() = dead_heap();
+        delete h;
+    }
+};
+
+struct shared_heap{
+    std::mutex m;
+    heap h;
+
+    static shared_heap& get(){
+        static shared_heap* s = new shared_heap();
+        return *s;
+    }
+};
+
+inline heap* local_heap(){
+    heap*& h = tls_heap();
+    if(!h){
+        static thread_local heap_guard guard;
+        (void)guard;
+        h = new heap();
+    }
+    return h;
+}
+
+inline void* allocate(size_t bytes){
+    if(bytes == 0) bytes = 1;
+    if(bytes > max_block) return ::operator new(bytes);
+    heap* h = local_heap();
+    if(h == dead_heap()){
+        shared_heap& sh = shared_heap::get();
+        std::lock_guard<std::mutex> lg(sh.m);
+        return sh.h.allocate(class_of(bytes));
+    }
+    return h->allocate(class_of(bytes));
+}
+
+inline void deallocate(void* p, size_t bytes){
+    if(!p) return;
+    if(bytes == 0) bytes = 1;
+    if(bytes > max_block){
+        ::operator delete(p);
+        return;
+    }
+    slab* s = slab::of(p);
+    heap* h = tls_heap();
+    if(h && h != dead_heap() && s->owner.load(std::memory_order_relaxed) == h) s->push_local(p);
+    else                                                                       s->push_remote(p);
+}
+
+}
+
+template<typename T>
+struct pool_allocator{
+
+    using value_type = T;
+
+    pool_allocator() = default;
+
+    template<typename U>
+    pool_allocator(const pool_allocator<U>&){}
+
+    T* allocate(size_t n){
+        if constexpr (alignof (T) > pool::granularity)
+            return static_cast<T*>(::operator new(n * sizeof (T), std::align_val_t(alignof (T))));
+        else
+            return static_cast<T*>(pool::allocate(n * sizeof (T)));
+    }
+
+    void deallocate(T* p, size_t n){
+        if constexpr (alignof (T) > pool::granularity)
+            ::operator delete(p, std::align_val_t(alignof (T)));
+        else
+            pool::deallocate(p, n * sizeof (T));
+    }
+
+    template<typename U>
+    bool operator==(const pool_allocator<U>&) const{
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const pool_allocator<U>&) const{
+        return false;
+    }
+};
+
+}
@@ -0,0 +1,286 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <string_parts.hpp>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace my {
+namespace search {
+
+template<typename CharT, typename TraitsT>
+constexpr bool vectorizable = std::is_same_v<TraitsT, std::char_traits<CharT>> && std::is_integral_v<CharT> &&
+                              (sizeof (CharT) == 1 || sizeof (CharT) == 2 || sizeof (CharT) == 4);
+
+template<typename CharT, typename TraitsT>
+constexpr bool libc_backed = std::is_same_v<TraitsT, std::char_traits<CharT>> &&
+                             (std::is_same_v<CharT, char> || std::is_same_v<CharT, wchar_t>);
+
+#if defined(__SSE2__)
+template<typename CharT>
+__m128i broadcast(CharT v){
+    if constexpr (sizeof (CharT) == 1) return _mm_set1_epi8(static_cast<char>(v));
+    else if constexpr (sizeof (CharT) == 2) return _mm_set1_epi16(static_cast<short>(v));
+    else return _mm_set1_epi32(static_cast<int>(v));
+}
+
+template<typename CharT>
+__m128i load(const CharT* data){
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+template<typename CharT>
+__m128i equal_mask(__m128i lhs, __m128i rhs){
+    if constexpr (sizeof (CharT) == 1) return _mm_cmpeq_epi8(lhs, rhs);
+    else if constexpr (sizeof (CharT) == 2) return _mm_cmpeq_epi16(lhs, rhs);
+    else return _mm_cmpeq_epi32(lhs, rhs);
+}
+
+template<typename CharT>
+uint32_t equal_lanes(__m128i lhs, __m128i rhs){
+    __m128i eq = equal_mask<CharT>(lhs, rhs);
+    constexpr uint32_t first = sizeof (CharT) == 1 ? 0xFFFF : sizeof (CharT) == 2 ? 0x5555 : 0x1111;
+    return static_cast<uint32_t>(_mm_movemask_epi8(eq)) & first;
+}
+
+template<typename CharT>
+__m128i subtract(__m128i lhs, __m128i rhs){
+    if constexpr (sizeof (CharT) == 1) return _mm_sub_epi8(lhs, rhs);
+    else if constexpr (sizeof (CharT) == 2) return _mm_sub_epi16(lhs, rhs);
+    else return _mm_sub_epi32(lhs, rhs);
+}
+
+template<typename CharT>
+size_t horizontal_sum(__m128i v){
+    using lane = std::conditional_t<sizeof (CharT) == 1, uint8_t, std::conditional_t<sizeof (CharT) == 2, uint16_t, uint32_t>>;
+    lane lanes[16 / sizeof (CharT)];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), v);
+    size_t res = 0;
+    for(lane l : lanes) res += l;
+    return res;
+}
+#endif
+
+template<typename TraitsT, typename CharT>
+const CharT* find_char(const CharT* data, size_t n, CharT v){
+#if defined(__SSE2__)
+    if constexpr (vectorizable<CharT, TraitsT> && !libc_backed<CharT, TraitsT>){
+        constexpr size_t lanes = 16 / sizeof (CharT);
+        const __m128i needle = broadcast(v);
+        size_t i = 0;
+        for(; i + lanes <= n; i += lanes){
+            uint32_t mask = equal_lanes<CharT>(load(data + i), needle);
+            if(mask) return data + i + __builtin_ctz(mask) / sizeof (CharT);
+        }
+        return TraitsT::find(data + i, n - i, v);
+    }
+#endif
+    return TraitsT::find(data, n, v);
+}
+
+template<typename TraitsT, typename CharT>
+size_t count_char(const CharT* data, size_t n, CharT v){
+    size_t res = 0;
+    size_t i = 0;
+#if defined(__SSE2__)
+    if constexpr (vectorizable<CharT, TraitsT>){
+        constexpr size_t lanes = 16 / sizeof (CharT);
+        constexpr size_t flush = 255;
+        const __m128i needle = broadcast(v);
+        while(i + lanes <= n){
+            __m128i acc = _mm_setzero_si128();
+            for(size_t k = 0; k < flush && i + lanes <= n; ++k, i += lanes)
+                acc = subtract<CharT>(acc, equal_mask<CharT>(load(data + i), needle));
+            res += horizontal_sum<CharT>(acc);
+        }
+    }
+#endif
+    for(; i < n; ++i) if(TraitsT::eq(data[i], v)) res++;
+    return res;
+}
+
+template<typename TraitsT, typename CharT>
+int compare(const CharT* lhs, const CharT* rhs, size_t n){
+#if defined(__SSE2__)
+    if constexpr (vectorizable<CharT, TraitsT> && !libc_backed<CharT, TraitsT>){
+        constexpr size_t lanes = 16 / sizeof (CharT);
+        constexpr uint32_t all = sizeof (CharT) == 1 ? 0xFFFF : sizeof (CharT) == 2 ? 0x5555 : 0x1111;
+        size_t i = 0;
+        for(; i + lanes <= n; i += lanes){
+            uint32_t diff = equal_lanes<CharT>(load(lhs + i), load(rhs + i)) ^ all;
+            if(diff){
+                size_t pos = i + __builtin_ctz(diff) / sizeof (CharT);
+                return TraitsT::lt(lhs[pos], rhs[pos]) ? -1 : 1;
+            }
+        }
+        return TraitsT::compare(lhs + i, rhs + i, n - i);
+    }
+#endif
+    return TraitsT::compare(lhs, rhs, n);
+}
+
+template<typename TraitsT, typename CharT>
+const CharT* find(const CharT* data, size_t n, const CharT* needle, size_t m){
+    if(m == 0) return data;
+    if(m > n) return nullptr;
+    const CharT* last = data + n - m;
+    const CharT* cur  = data;
+    while(cur <= last){
+        cur = find_char<TraitsT>(cur, last - cur + 1, needle[0]);
+        if(!cur) return nullptr;
+        if(compare<TraitsT>(cur + 1, needle + 1, m - 1) == 0) return cur;
+        cur++;
+    }
+    return nullptr;
+}
+
+template<typename TraitsT, typename CharT>
+size_t count(const CharT* data, size_t n, const CharT* needle, size_t m){
+    if(m == 0) return 0;
+    size_t res = 0;
+    const CharT* end = data + n;
+    for(const CharT* cur = data; (cur = find<TraitsT>(cur, end - cur, needle, m)); cur += m) res++;
+    return res;
+}
+
+template<typename TraitsT, typename CharT>
+CharT* replace_copy(CharT* out, const CharT* data, size_t n,
+                    const CharT* needle, size_t m,
+                    const CharT* repl, size_t k){
+    const CharT* end = data + n;
+    const CharT* cur = data;
+    for(const CharT* hit; (hit = find<TraitsT>(cur, end - cur, needle, m)); cur = hit + m){
+        TraitsT::move(out, cur, hit - cur);
+        out += hit - cur;
+        TraitsT::copy(out, repl, k);
+        out += k;
+    }
+    TraitsT::move(out, cur, end - cur);
+    return out + (end - cur);
+}
+
+template<typename CharT>
+bool overlaps(const CharT* data, size_t n, const CharT* ptr, size_t m){
+    std::less<const CharT*> less;
+    return m != 0 && n != 0 && less(ptr, data + n) && less(data, ptr + m);
+}
+
+template<typename CharT,
+         size_t N,
+         typename TraitsT = std::char_traits<CharT>>
+class literal{
+
+    static_assert(N > 0, "literal needle must not be empty");
+
+    using view_type = std::basic_string_view<CharT, TraitsT>;
+
+    static constexpr size_t unroll = 32;
+
+    CharT  needle_[N] = {};
+    size_t shift_[256] = {};
+
+    static constexpr size_t slot(CharT c){
+        return static_cast<size_t>(static_cast<std::make_unsigned_t<CharT>>(c)) & 0xFF;
+    }
+
+    template<size_t... I>
+    constexpr bool equal(const CharT* p, std::index_sequence<I...>) const{
+        return (TraitsT::eq(p[I], needle_[I]) && ...);
+    }
+
+    constexpr bool equal(const CharT* p) const{
+        if constexpr (N <= unroll) return equal(p, std::make_index_sequence<N>());
+        else                       return TraitsT::compare(p, needle_, N) == 0;
+    }
+
+    size_t find_horspool(const CharT* data, size_t n, size_t from) const{
+        for(size_t i = from; i + N <= n; i += shift_[slot(data[i + N - 1])])
+            if(equal(data + i)) return i;
+        return view_type::npos;
+    }
+
+#if defined(__SSE2__)
+    size_t find_sse2(const CharT* data, size_t n, size_t from) const{
+        constexpr size_t lanes = 16 / sizeof (CharT);
+        const __m128i first = broadcast(needle_[0]);
+        const __m128i last  = broadcast(needle_[N - 1]);
+        size_t i = from;
+        for(; i + N - 1 + lanes <= n; i += lanes){
+            uint32_t mask = equal_lanes<CharT>(load(data + i), first) & equal_lanes<CharT>(load(data + i + N - 1), last);
+            for(; mask; mask &= mask - 1){
+                size_t pos = i + __builtin_ctz(mask) / sizeof (CharT);
+                if(equal(data + pos)) return pos;
+            }
+        }
+        return find_horspool(data, n, i);
+    }
+#endif
+
+public:
+
+    constexpr literal(const CharT (&str)[N + 1]){
+        for(size_t i = 0; i < N; ++i) needle_[i] = str[i];
+        for(size_t i = 0; i < 256; ++i) shift_[i] = N;
+        for(size_t i = 0; i + 1 < N; ++i) shift_[slot(needle_[i])] = N - 1 - i;
+    }
+
+    static constexpr size_t size(){
+        return N;
+    }
+
+    constexpr view_type view() const{
+        return view_type(needle_, N);
+    }
+
+    constexpr size_t shift(CharT c) const{
+        return shift_[slot(c)];
+    }
+
+    size_t find(view_type text, size_t from = 0) const{
+        if(from > text.size() || text.size() - from < N) return view_type::npos;
+        if constexpr (N == 1){
+            const CharT* hit = find_char<TraitsT>(text.data() + from, text.size() - from, needle_[0]);
+            return hit ? static_cast<size_t>(hit - text.data()) : view_type::npos;
+        }
+#if defined(__SSE2__)
+        else if constexpr (vectorizable<CharT, TraitsT>){
+            return find_sse2(text.data(), text.size(), from);
+        }
+#endif
+        else{
+            return find_horspool(text.data(), text.size(), from);
+        }
+    }
+
+    template<typename StringT,
+             std::enable_if_t<!std::is_convertible_v<const StringT&, view_type>, int> = 0>
+    size_t find(const StringT& str, size_t from = 0) const{
+        return find(as_view<view_type>(str), from);
+    }
+
+    template<typename StringT>
+    bool contains(const StringT& str) const{
+        return find(as_view<view_type>(str)) != view_type::npos;
+    }
+
+    template<typename StringT>
+    size_t count(const StringT& str) const{
+        view_type text = as_view<view_type>(str);
+        size_t res = 0;
+        for(size_t pos = find(text); pos != view_type::npos; pos = find(text, pos + N)) res++;
+        return res;
+    }
+};
+
+template<typename CharT, size_t M>
+literal(const CharT (&)[M]) -> literal<CharT, M - 1>;
+
+}
+}
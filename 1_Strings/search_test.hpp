@@ -0,0 +1,85 @@
+#pragma once
+#include <string.hpp>
+#include <cow_string.hpp>
+#include <search.hpp>
+#include <string_view>
+#include <string>
+#include <cassert>
+#include <iostream>
+
+void Test_search_runtime(){
+    std::string_view text = "abracadabra";
+    using traits = std::char_traits<char>;
+    assert(my::search::find<traits>(text.data(), text.size(), "cad", 3) == text.data() + 4);
+    assert(my::search::find<traits>(text.data(), text.size(), "dab", 3) == text.data() + 6);
+    assert(my::search::find<traits>(text.data(), text.size(), "abx", 3) == nullptr);
+    assert(my::search::count<traits>(text.data(), text.size(), "abra", 4) == 2);
+    assert(my::search::count<traits>(text.data(), text.size(), "a", 1) == 5);
+}
+
+void Test_search_literal(){
+    constexpr my::search::literal error("ERROR");
+    static_assert(error.size() == 5);
+    static_assert(error.shift('R') == 2);
+    static_assert(error.shift('O') == 1);
+    static_assert(error.shift('E') == 4);
+    static_assert(error.shift('x') == 5);
+
+    std::string line(200, '.');
+    line += "ERRO ERRORERROR";
+    assert(error.find(std::string_view(line)) == 205);
+    assert(error.count(line) == 2);
+    assert(error.find(std::string_view(line), 206) == 210);
+    assert(error.find(std::string_view(line), 211) == std::string_view::npos);
+    assert(error.contains(my::cow_string("level=ERROR msg=timeout")));
+    assert(!error.contains(my::string("level=WARN")));
+    assert(error.find(my::string("ERROR")) == 0);
+    assert(error.find(my::string("ERRO")) == std::string_view::npos);
+
+    constexpr my::search::literal comma(",");
+    assert(comma.count(std::string_view("a,b,,c")) == 3);
+
+    constexpr my::search::literal wide(u"needle");
+    std::u16string hay = u"haystack with a needle in it";
+    assert(wide.find(std::u16string_view(hay)) == 16);
+
+    constexpr my::search::literal very_long("0123456789abcdef0123456789abcdef0123456789");
+    std::string digits;
+    for(int i = 0; i < 10; ++i) digits += "0123456789abcdef";
+    assert(very_long.find(std::string_view(digits)) == 0);
+    assert(very_long.count(digits) == 3);
+}
+
+template<typename CharT>
+void Test_search_kernels(){
+    using traits = std::char_traits<CharT>;
+    std::basic_string<CharT> text(100, CharT('.'));
+    text[37] = CharT('x');
+    text[90] = CharT('x');
+    text[99] = CharT('x');
+    assert(my::search::find_char<traits>(text.data(), text.size(), CharT('x')) == text.data() + 37);
+    assert(my::search::find_char<traits>(text.data(), 37, CharT('x')) == nullptr);
+    assert(my::search::count_char<traits>(text.data(), text.size(), CharT('x')) == 3);
+    assert(my::search::count_char<traits>(text.data(), text.size(), CharT('.')) == 97);
+
+    std::basic_string<CharT> other = text;
+    assert(my::search::compare<traits>(text.data(), other.data(), text.size()) == 0);
+    other[64] = CharT('~');
+    assert(my::search::compare<traits>(text.data(), other.data(), text.size()) < 0);
+    assert(my::search::compare<traits>(other.data(), text.data(), text.size()) > 0);
+    assert(my::search::compare<traits>(text.data(), other.data(), 64) == 0);
+
+    const CharT needle[] = {CharT('.'), CharT('x'), CharT('.')};
+    assert(my::search::find<traits>(text.data(), text.size(), needle, 3) == text.data() + 36);
+}
+
+void Test_search(){
+    Test_search_kernels<char>();
+    Test_search_kernels<unsigned char>();
+    Test_search_kernels<char16_t>();
+    Test_search_kernels<char32_t>();
+    Test_search_kernels<wchar_t>();
+    Test_search_runtime();
+    Test_search_literal();
+    std::cout << "Search tests passed\n";
+}
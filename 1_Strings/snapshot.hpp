@@ -0,0 +1,259 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cow_string.hpp>
+#include <utility.hpp>
+
+namespace my {
+
+namespace snapshot_format {
+
+constexpr char     magic[8]  = {'M', 'Y', 'S', 'N', 'A', 'P', '0', '1'};
+constexpr uint32_t version   = 1;
+constexpr uint32_t byte_mark = 0x01020304;
+
+struct header{
+    char     magic[8];
+    uint32_t version;
+    uint32_t byte_mark;
+    uint32_t char_size;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t chars;
+};
+
+static_assert(sizeof (header) == 40, "snapshot header must stay packed");
+
+inline size_t blob_offset(uint64_t count){
+    return sizeof (header) + (count + 1) * sizeof (uint64_t);
+}
+
+class file{
+
+    int fd_ = -1;
+
+public:
+
+    file(const char* path, int flags, mode_t mode = 0) : fd_(::open(path, flags | O_CLOEXEC, mode)){
+        if(fd_ < 0) throw std::system_error(errno, std::generic_category(), path);
+    }
+
+    ~file(){
+        if(fd_ >= 0) ::close(fd_);
+    }
+
+    file(const file&) = delete;
+    file& operator=(const file&) = delete;
+
+    int get() const{
+        return fd_;
+    }
+
+    void close(){
+        int fd = fd_;
+        fd_ = -1;
+        if(::close(fd) != 0) throw std::system_error(errno, std::generic_category(), "close");
+    }
+};
+
+inline void write_all(int fd, iovec* iov, size_t n){
+    while(n){
+        ssize_t done = ::writev(fd, iov, static_cast<int>(std::min<size_t>(n, IOV_MAX)));
+        if(done < 0){
+            if(errno == EINTR) continue;
+            throw std::system_error(errno, std::generic_category(), "writev");
+        }
+        size_t left = static_cast<size_t>(done);
+        while(n && left >= iov->iov_len){
+            left -= iov->iov_len;
+            iov++;
+            n--;
+        }
+        if(n){
+            iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
+    }
+}
+
+}
+
+template<typename InputIt>
+void write_snapshot(const char* path, InputIt beg, InputIt end){
+    using view_type = string_view_of_t<typename std::iterator_traits<InputIt>::value_type>;
+    using char_type = typename view_type::value_type;
+    static_assert(std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>,
+                  "write_snapshot walks the range twice");
+
+    std::vector<uint64_t> offsets(1, 0);
+    for(auto cur = beg; cur != end; ++cur) offsets.push_back(offsets.back() + as_view<view_type>(*cur).size() + 1);
+
+    snapshot_format::header head{};
+    std::memcpy(head.magic, snapshot_format::magic, sizeof (head.magic));
+    head.version   = snapshot_format::version;
+    head.byte_mark = snapshot_format::byte_mark;
+    head.char_size = sizeof (char_type);
+    head.count     = offsets.size() - 1;
+    head.chars     = offsets.back();
+
+    static const char_type terminator = char_type();
+    std::vector<iovec> iov;
+    iov.reserve(2 + 2 * head.count);
+    iov.push_back(iovec{&head, sizeof (head)});
+    iov.push_back(iovec{offsets.data(), offsets.size() * sizeof (uint64_t)});
+    for(auto cur = beg; cur != end; ++cur){
+        view_type str = as_view<view_type>(*cur);
+        if(!str.empty()) iov.push_back(iovec{const_cast<char_type*>(str.data()), str.size() * sizeof (char_type)});
+        iov.push_back(iovec{const_cast<char_type*>(&terminator), sizeof (char_type)});
+    }
+
+    snapshot_format::file out(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    snapshot_format::write_all(out.get(), iov.data(), iov.size());
+    out.close();
+}
+
+template<typename RangeT>
+void write_snapshot(const char* path, const RangeT& range){
+    write_snapshot(path, std::begin(range), std::end(range));
+}
+
+template<typename CharT,
+         typename TraitsT = std::char_traits<CharT>,
+         typename Allocator = std::allocator<CharT>>
+class base_snapshot{
+
+    using string_type = cow_base_string<CharT, TraitsT, Allocator>;
+    using view_type   = std::basic_string_view<CharT, TraitsT>;
+
+    string_type buffer_;
+    const uint64_t* offsets_ = nullptr;
+    size_t count_ = 0;
+    size_t bytes_ = 0;
+
+    static void corrupt(const char* what){
+        throw std::runtime_error(std::string("Invalid snapshot: ") + what);
+    }
+
+    const CharT* entry(size_t idx) const{
+        const CharT* data = buffer_.c_str() + offsets_[idx];
+        if(!TraitsT::eq(buffer_.c_str()[offsets_[idx + 1] - 1], CharT())) corrupt("entry is not terminated");
+        return data;
+    }
+
+public:
+
+    explicit base_snapshot(const char* path, const Allocator& alloc = Allocator()) : buffer_(alloc){
+        snapshot_format::file in(path, O_RDONLY);
+        struct stat st;
+        if(::fstat(in.get(), &st) != 0) throw std::system_error(errno, std::generic_category(), path);
+        const size_t bytes = static_cast<size_t>(st.st_size);
+        if(bytes < snapshot_format::blob_offset(0)) corrupt("file is too small");
+
+        void* map = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, in.get(), 0);
+        if(map == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "mmap");
+        char* base = static_cast<char*>(map);
+        auto unmap = [base, bytes](CharT*){
+            ::munmap(base, bytes);
+        };
+
+        snapshot_format::header head;
+        std::memcpy(&head, base, sizeof (head));
+        const char* error = nullptr;
+        if(std::memcmp(head.magic, snapshot_format::magic, sizeof (head.magic)) != 0) error = "bad magic";
+        else if(head.version != snapshot_format::version)                              error = "unsupported version";
+        else if(head.byte_mark != snapshot_format::byte_mark)                          error = "foreign byte order";
+        else if(head.char_size != sizeof (CharT))                                      error = "character size mismatch";
+        else if(head.count > (bytes - sizeof (head)) / sizeof (uint64_t) || head.chars > bytes ||
+                snapshot_format::blob_offset(head.count) + head.chars * sizeof (CharT) != bytes) error = "size mismatch";
+        if(error){
+            unmap(nullptr);
+            corrupt(error);
+        }
+
+        const uint64_t* offsets = reinterpret_cast<const uint64_t*>(base + sizeof (head));
+        if(offsets[0] != 0 || offsets[head.count] != head.chars){
+            unmap(nullptr);
+            corrupt("offset table does not cover the blob");
+        }
+        for(size_t idx = 0; idx < head.count; ++idx){
+            if(offsets[idx + 1] <= offsets[idx]){
+                unmap(nullptr);
+                corrupt("offset table is not increasing");
+            }
+        }
+
+        if(head.chars == 0){
+            unmap(nullptr);
+            return;
+        }
+        CharT* blob = reinterpret_cast<CharT*>(base + snapshot_format::blob_offset(head.count));
+        buffer_  = string_type::adopt(blob, head.chars - 1, head.chars, unmap, alloc);
+        offsets_ = offsets;
+        count_   = head.count;
+        bytes_   = bytes;
+    }
+
+    size_t size() const{
+        return count_;
+    }
+
+    bool empty() const{
+        return count_ == 0;
+    }
+
+    size_t bytes() const{
+        return bytes_;
+    }
+
+    size_t length(size_t idx) const{
+        return offsets_[idx + 1] - offsets_[idx] - 1;
+    }
+
+    view_type operator[](size_t idx) const{
+        return view_type(entry(idx), length(idx));
+    }
+
+    view_type view(size_t idx) const{
+        return (*this)[idx];
+    }
+
+    const CharT* c_str(size_t idx) const{
+        return entry(idx);
+    }
+
+    string_type string(size_t idx) const{
+        entry(idx);
+        return string_type::slice(buffer_, offsets_[idx], length(idx));
+    }
+
+    std::vector<string_type> strings() const{
+        std::vector<string_type> res;
+        res.reserve(count_);
+        for(size_t idx = 0; idx < count_; ++idx) res.push_back(string(idx));
+        return res;
+    }
+
+    const string_type& buffer() const{
+        return buffer_;
+    }
+};
+
+using snapshot = my::base_snapshot<char>;
+
+}
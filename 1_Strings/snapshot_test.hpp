@@ -0,0 +1,115 @@
+#pragma once
+#include <string.hpp>
+#include <cow_string.hpp>
+#include <snapshot.hpp>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <cassert>
+#include <iostream>
+
+std::string snapshot_path(const char* name){
+    return (std::filesystem::temp_directory_path() / (std::string("my_strings_") + std::to_string(::getpid()) + "_" + name)).string();
+}
+
+void Test_snapshot_roundtrip(){
+    const std::string path = snapshot_path("roundtrip.snap");
+    std::vector<my::cow_string> source;
+    for(int i = 0; i < 5000; ++i) source.emplace_back(("entry-" + std::to_string(i * 7919)).c_str());
+    source[10] = my::cow_string();
+    my::write_snapshot(path.c_str(), source);
+
+    std::vector<my::cow_string> loaded;
+    {
+        my::snapshot snap(path.c_str());
+        assert(snap.size() == source.size());
+        for(size_t i = 0; i < source.size(); ++i){
+            assert(snap[i] == std::string_view(source[i].c_str(), source[i].size()));
+            assert(snap.c_str(i)[snap.length(i)] == '\0');
+        }
+        assert(snap.view(10).empty());
+
+        auto before = my::instrumentation::collect();
+        loaded = snap.strings();
+        auto diff = my::instrumentation::collect() - before;
+#ifdef MY_STRING_INSTRUMENTATION
+        assert(diff[my::instrumentation::event::deep_copy] == 0);
+#endif
+        (void)diff;
+        assert(loaded[3].c_str() == snap.c_str(3));
+        assert(snap.buffer().references() == source.size() + 1);
+    }
+    assert(loaded[4999] == source[4999]);
+    assert(loaded[0] == "entry-0");
+
+    my::cow_string copy(loaded[1]);
+    loaded[1][0] = 'E';
+    assert(loaded[1] == "Entry-7919");
+    assert(copy == "entry-7919");
+    assert(loaded[2] == "entry-15838");
+    loaded[2].push_back('!');
+    assert(loaded[2] == "entry-15838!");
+    assert(loaded[3] == "entry-23757");
+    loaded.clear();
+    std::filesystem::remove(path);
+}
+
+void Test_snapshot_sources(){
+    const std::string path = snapshot_path("sources.snap");
+    std::vector<my::string> strings{"alpha", "", "gamma"};
+    my::write_snapshot(path.c_str(), strings.begin(), strings.end());
+    my::snapshot snap(path.c_str());
+    assert(snap.size() == 3 && snap[0] == "alpha" && snap[1].empty() && snap[2] == "gamma");
+
+    my::write_snapshot(path.c_str(), std::vector<std::string_view>{});
+    my::snapshot none(path.c_str());
+    assert(none.empty());
+
+    std::vector<my::cow_base_string<char32_t>> wide{my::cow_base_string<char32_t>(U"wide"), my::cow_base_string<char32_t>(U"entries")};
+    my::write_snapshot(path.c_str(), wide);
+    my::base_snapshot<char32_t> wsnap(path.c_str());
+    assert(wsnap.size() == 2 && wsnap[1] == std::u32string_view(U"entries"));
+    assert(wsnap.string(0) == wide[0]);
+
+    bool thrown = false;
+    try{
+        my::snapshot wrong(path.c_str());
+    }
+    catch(const std::runtime_error&){
+        thrown = true;
+    }
+    assert(thrown);
+    std::filesystem::remove(path);
+}
+
+void Test_snapshot_corrupt(){
+    const std::string path = snapshot_path("corrupt.snap");
+    my::write_snapshot(path.c_str(), std::vector<std::string_view>{"one", "two", "three"});
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 2);
+    bool thrown = false;
+    try{
+        my::snapshot snap(path.c_str());
+    }
+    catch(const std::runtime_error&){
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::filesystem::remove(path);
+    thrown = false;
+    try{
+        my::snapshot snap(path.c_str());
+    }
+    catch(const std::system_error& e){
+        thrown = e.code() == std::errc::no_such_file_or_directory;
+    }
+    assert(thrown);
+}
+
+void Test_snapshot(){
+    Test_snapshot_roundtrip();
+    Test_snapshot_sources();
+    Test_snapshot_corrupt();
+    std::cout << "Snapshot tests passed\n";
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <string_view>
+#include <cow_string.hpp>
+#include <search.hpp>
+
+namespace my {
+
+template<typename CharT,
+         typename TraitsT = std::char_traits<CharT>,
+         typename Allocator = std::allocator<CharT>>
+class split_arena{
+
+    using string_type  = cow_base_string<CharT, TraitsT, Allocator>;
+    using view_type    = std::basic_string_view<CharT, TraitsT>;
+    using offset_alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<size_t>;
+
+    string_type buffer_;
+    std::vector<size_t, offset_alloc> offsets_;
+
+public:
+
+    split_arena(const CharT* data, size_t n, CharT sep, const Allocator& alloc = Allocator())
+        : buffer_(alloc), offsets_(offset_alloc(alloc)){
+        size_t count = search::count_char<TraitsT>(data, n, sep);
+        offsets_.reserve(count + 2);
+
+        CharT* chars = buffer_.create_exact(n + 1);
+        TraitsT::copy(chars, data, n);
+        chars[n] = CharT();
+
+        offsets_.push_back(0);
+        for(const CharT* p = chars; (p = search::find_char<TraitsT>(p, chars + n - p, sep)); ++p){
+            chars[p - chars] = CharT();
+            offsets_.push_back(p - chars + 1);
+        }
+        offsets_.push_back(n + 1);
+    }
+
+    size_t size() const{
+        return offsets_.size() - 1;
+    }
+
+    bool empty() const{
+        return size() == 0;
+    }
+
+    size_t length(size_t idx) const{
+        return offsets_[idx + 1] - offsets_[idx] - 1;
+    }
+
+    view_type operator[](size_t idx) const{
+        return view_type(buffer_.c_str() + offsets_[idx], length(idx));
+    }
+
+    view_type view(size_t idx) const{
+        return (*this)[idx];
+    }
+
+    const CharT* c_str(size_t idx) const{
+        return buffer_.c_str() + offsets_[idx];
+    }
+
+    string_type string(size_t idx) const{
+        return string_type::slice(buffer_, offsets_[idx], length(idx));
+    }
+
+    const string_type& buffer() const{
+        return buffer_;
+    }
+
+    const std::vector<size_t, offset_alloc>& offsets() const{
+        return offsets_;
+    }
+};
+
+}
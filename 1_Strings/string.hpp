@@ -1,16 +1,27 @@
 #pragma once
 #include <stdexcept>
+#include <algorithm>
 #include <cstring>
+#include <memory_resource>
+#include <string_view>
 #include <iterator.hpp>
+#include <search.hpp>
+#include <allocator.hpp>
+#include <pool.hpp>
+#include <instrumentation.hpp>
+#include <numeric.hpp>
 namespace my {
 
 template<typename CharT,
          typename TraitsT = std::char_traits<CharT>,
          typename Allocator = std::allocator<CharT>>
-class base_string{
+class base_string : private allocator_holder<Allocator>{
 
-    using it       = StringIterator<CharT>;
-    using const_it = StringIterator<const CharT>;
+    using it           = StringIterator<CharT>;
+    using const_it     = StringIterator<const CharT>;
+    using holder       = allocator_holder<Allocator>;
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using view_type    = std::basic_string_view<CharT, TraitsT>;
 
     size_t size_ = 0;
 
@@ -19,118 +30,222 @@ class base_string{
         size_t cap  = 0;
     };
 
+    static constexpr size_t sso = sizeof (Large) / sizeof (CharT);
+
     union{
         Large large;
-        CharT small[sizeof (Large)];
+        CharT small[sso];
     };
 
+    template<typename, typename, typename>
+    friend class base_string;
+
+    CharT* allocate(size_t n){
+        MY_STRING_RECORD_ALLOC(n * sizeof (CharT));
+        return alloc_traits::allocate(this->alloc(), n);
+    }
+
+    void deallocate(CharT* data, size_t n){
+        MY_STRING_RECORD(dealloc);
+        alloc_traits::deallocate(this->alloc(), data, n);
+    }
+
     void create(const CharT* data, size_t n){
-        if(n < sizeof (Large)){
-            std::memset(&small[0], '\0', sizeof (Large));
-            std::memcpy(&small[0], data, n);
+        if(n < sso){
+            MY_STRING_RECORD(sso_hit);
+            TraitsT::assign(&small[0], sso, CharT());
+            if(n) TraitsT::copy(&small[0], data, n - 1);
             size_ = n;
         }
         else{
-            Allocator alloc;
-            large.data = alloc.allocate(2 * n);
-            std::memcpy(large.data, data, n);
+            MY_STRING_RECORD(heap_spill);
+            large.data = allocate(2 * n);
+            TraitsT::copy(large.data, data, n - 1);
             size_ = n;
             large.cap = 2 * n;
-            large.data[n] = '\0';
+            large.data[n - 1] = CharT();
         }
     }
 
     void restore(){
-        Allocator alloc;
-        CharT* it = alloc.allocate((size_ +  1) * 2);
-        std::memcpy(it, choose(), size_ - 1);
-        alloc.deallocate(large.data, large.cap);
-        large.cap = (size_ + 1) * 2;
+        size_t cap = (size_ +  1) * 2;
+        CharT* it = allocate(cap);
+        TraitsT::copy(it, choose(), size_);
+        if(size_ >= sso) deallocate(large.data, large.cap);
+        large.cap = cap;
         large.data = it;
     }
 
     CharT* choose(){
         CharT* it = nullptr;
-        if(size_ < sizeof (Large)) it = &small[0];
-        else                       it = large.data;
+        if(size_ < sso) it = &small[0];
+        else            it = large.data;
         return it;
     }
 
-    CharT* choose(const base_string& str) const{
-        CharT* it = nullptr;
-        if(str.size_ < sizeof (Large)) it = &str.small[0];
-        else                           it = str.large.data;
+    const CharT* choose() const{
+        const CharT* it = nullptr;
+        if(size_ < sso) it = &small[0];
+        else            it = large.data;
         return it;
     }
 
+    template<typename CharU,
+             typename TraitsU,
+             typename AllocatorU>
+    static const CharU* choose(const base_string<CharU, TraitsU, AllocatorU>& str){
+        return str.choose();
+    }
+
+    static constexpr size_t storage = sizeof (Large);
+
+    void reset() noexcept{
+        TraitsT::assign(&small[0], sso, CharT());
+        size_ = 0;
+    }
+
+    void steal(base_string& str) noexcept{
+        std::memcpy(static_cast<void*>(&large), static_cast<const void*>(&str.large), storage);
+        size_ = str.size_;
+        str.reset();
+    }
+
+    void release() noexcept{
+        if(size_ >= sso) deallocate(large.data, large.cap);
+        reset();
+    }
+
+    bool fits(size_t n) const{
+        if(n < sso) return size_ < sso;
+        return size_ >= sso && n <= large.cap;
+    }
+
+    template<typename F>
+    void rebuild(size_t n, size_t cap, F fill){
+        CharT buf[sso] = {};
+        CharT* out = n < sso ? buf : allocate(cap);
+        fill(out);
+        out[n - 1] = CharT();
+        if(size_ >= sso) deallocate(large.data, large.cap);
+        if(n < sso){
+            TraitsT::copy(&small[0], buf, sso);
+        }
+        else{
+            MY_STRING_RECORD(heap_spill);
+            large.data = out;
+            large.cap = cap;
+        }
+        size_ = n;
+    }
+
 public:
 
     ~base_string(){
-        if(size_ >= sizeof (Large)){
-            Allocator alloc;
-            alloc.deallocate(large.data, large.cap);
+        if(size_ >= sso){
+            deallocate(large.data, large.cap);
         }
     }
 
-    base_string(){}
+    base_string(){
+        reset();
+    }
 
-    base_string(const CharT* data, size_t n){
-        create(data, n);
+    explicit base_string(const Allocator& alloc) : holder(alloc){
+        reset();
     }
 
-    base_string(const CharT* data){
-        size_t n = std::strlen(data);
+    base_string(const CharT* data, size_t n, const Allocator& alloc = Allocator()) : holder(alloc){
+        create(data, n + 1);
+    }
+
+    base_string(const CharT* data, const Allocator& alloc = Allocator()) : holder(alloc){
+        size_t n = TraitsT::length(data) + 1;
         create(data, n);
     }
 
     template<size_t N>
-    base_string(const CharT (&data)[N]){
+    base_string(const CharT (&data)[N], const Allocator& alloc = Allocator()) : holder(alloc){
         create(data, N);
     }
 
-    base_string(const base_string& str){
+    base_string(const base_string& str)
+        : holder(alloc_traits::select_on_container_copy_construction(str.alloc())){
+        MY_STRING_RECORD(deep_copy);
         create(choose(str), str.size_);
     }
 
-    base_string(base_string&& str){
-        CharT* it = choose(str);
-        create(it, str.size_);
-        if(it == str.large.data){
-            Allocator alloc;
-            alloc.deallocate(str.large.data, str.size_);
-            str.large.data = nullptr;
-        }
-        str.size_ = 0;
-        str.large.cap = 0;
+    base_string(const base_string& str, const Allocator& alloc) : holder(alloc){
+        MY_STRING_RECORD(deep_copy);
+        create(choose(str), str.size_);
+    }
+
+    base_string(base_string&& str) noexcept : holder(std::move(str.alloc())){
+        steal(str);
     }
 
     base_string& operator=(const base_string& str){
-        CharT* it = choose(str);
+        if(this == &str) return *this;
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::value){
+            if(this->alloc() != str.alloc()) release();
+            this->alloc() = str.alloc();
+        }
+        const CharT* it = choose(str);
+        if(size_ >= sso && str.size_ >= sso && str.size_ <= large.cap){
+            MY_STRING_RECORD(deep_copy);
+            TraitsT::copy(large.data, it, str.size_);
+            size_ = str.size_;
+            return *this;
+        }
+        release();
+        MY_STRING_RECORD(deep_copy);
         create(it, str.size_);
         return *this;
     }
 
-    base_string& operator=(base_string&& str){
-        CharT* it = choose(str);
-        create(it, str.size_);
-        if(it == str.large.data){
-            Allocator alloc;
-            alloc.deallocate(str.large.data, str.size_);
-            str.large.data = nullptr;
+    base_string& operator=(base_string&& str) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                                       alloc_traits::is_always_equal::value){
+        if(this == &str) return *this;
+        if constexpr (!alloc_traits::propagate_on_container_move_assignment::value &&
+                      !alloc_traits::is_always_equal::value){
+            if(this->alloc() != str.alloc()){
+                *this = static_cast<const base_string&>(str);
+                str.release();
+                return *this;
+            }
         }
-        str.size_ = 0;
-        str.large.cap = 0;
+        release();
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+            this->alloc() = std::move(str.alloc());
+        steal(str);
         return *this;
     }
 
+    void swap(base_string& str) noexcept{
+        if(this == &str) return;
+        if constexpr (alloc_traits::propagate_on_container_swap::value){
+            using std::swap;
+            swap(this->alloc(), str.alloc());
+        }
+        unsigned char tmp[storage];
+        std::memcpy(tmp, static_cast<const void*>(&large), storage);
+        std::memcpy(static_cast<void*>(&large), static_cast<const void*>(&str.large), storage);
+        std::memcpy(static_cast<void*>(&str.large), tmp, storage);
+        std::swap(size_, str.size_);
+    }
+
+    friend void swap(base_string& lhs, base_string& rhs) noexcept{
+        lhs.swap(rhs);
+    }
+
     template<typename CharU,
              typename TraitsU,
              typename AllocatorU,
-             std::enable_if_t<std::is_convertible_v<CharU, CharT>>>
+             std::enable_if_t<std::is_convertible_v<CharU, CharT>, int> = 0>
     bool operator==(const base_string<CharU, TraitsU, AllocatorU>& str) const{
         if(size_ != str.size_) return false;
-        CharT* lhs = choose();
-        CharT* rhs = choose(str);
+        const CharT* lhs = choose();
+        const CharU* rhs = choose(str);
+        if constexpr (std::is_same_v<CharU, CharT>) return search::compare<TraitsT>(lhs, rhs, size()) == 0;
         for(size_t i = 0; i < size_; ++i){
             if(!TraitsT::eq(*lhs, *rhs)) return false;
             lhs++; rhs++;
@@ -143,13 +258,13 @@ public:
     template<typename CharU,
              typename TraitsU,
              typename AllocatorU,
-             std::enable_if_t<std::is_constructible_v<CharU, CharT>>>
+             std::enable_if_t<std::is_constructible_v<CharU, CharT>, int> = 0>
     bool operator<(const base_string<CharU, TraitsU, AllocatorU>& str) const{
         if(size_ < str.size_) return true;
         if(size_ > str.size_) return false;
 
-        CharT* lhs = choose();
-        CharT* rhs = choose(str);
+        const CharT* lhs = choose();
+        const CharU* rhs = choose(str);
 
         for(size_t i = 0; i < size_; ++i){
             if(!TraitsT::lt(*lhs, *rhs)) return false;
@@ -166,7 +281,7 @@ public:
     }
 
     CharT operator[](size_t idx) const{
-        CharT* it = choose();
+        const CharT* it = choose();
 
         return it[idx];
     }
@@ -181,196 +296,288 @@ public:
     CharT at(size_t idx) const{
 
         if(idx > size_ - 2) throw std::out_of_range("");
-        CharT* it = choose();
+        const CharT* it = choose();
         return it[idx];
     }
 
+    Allocator get_allocator() const{
+        return this->alloc();
+    }
+
     const CharT* c_str() const{
         const CharT* it = nullptr;
-        if(size_ < sizeof (Large)) it = &small[0];
-        else                       it = large.data;
+        if(size_ < sso) it = &small[0];
+        else            it = large.data;
         return it;
     }
 
     it begin(){
-        CharT* it = choose();
-        return it(it);
+        CharT* ptr = choose();
+        return it(ptr);
     }
 
     it end(){
-        CharT* it = choose();
-
-        return it(it + size_);
+        CharT* ptr = choose();
+        return it(ptr + size());
     }
 
     const_it cbegin() const{
-        CharT* it = choose();
-        return const_it(it);
+        const CharT* ptr = choose();
+        return const_it(ptr);
     }
 
     const_it cend() const{
-        CharT* it = choose();
-
-        return const_it(it + size_);
+        const CharT* ptr = choose();
+        return const_it(ptr + size());
     }
 
     size_t size() const{
+        if(size_ == 0) return 0;
         return size_ - 1;
     }
 
     it front(){
-        CharT* it = choose();
-        return it(it);
+        CharT* ptr = choose();
+        return it(ptr);
     }
 
     const_it front() const{
-        CharT* it = choose();
-        return const_it(it);
+        const CharT* ptr = choose();
+        return const_it(ptr);
     }
 
     it back(){
-        CharT* it = choose();
-        return it(it);
+        CharT* ptr = choose();
+        return it(ptr + size() - 1);
     }
 
     const_it back() const{
-        CharT* it = choose();
-        return const_it(it);
+        const CharT* ptr = choose();
+        return const_it(ptr + size() - 1);
     }
 
     base_string copy() const{
-        CharT* it = choose();
-        return base_string(it, size_);
+        return base_string(*this, this->alloc());
     }
 
     void assign(const_it beg, const_it end){
         size_t size = end - beg + 1;
-        Allocator alloc;
-        if(size < sizeof (Large)){
-            if(large.data){
-                alloc.deallocate(large.cap);
-                large.cap = 0;
-            }
-            std::memcpy(&small[0], &(*beg), size - 1);
+        const CharT* data = beg.data;
+        if(size_ >= sso && size >= sso && size <= large.cap){
+            TraitsT::copy(large.data, data, size - 1);
+            large.data[size - 1] = CharT();
+            size_ = size;
+            return;
         }
-        else{
-            if(large.cap <= size){
-                alloc.deallocate(large.data, large.cap);
-                large.data = alloc.allocate(2 * size);
-                large.cap = 2 * size;
-            }
-            std::memcpy(large.data, &(*beg), size - 1);
+        if(size_ >= sso){
+            deallocate(large.data, large.cap);
         }
-        size_ = size;
-        large.data[size] = '\0';
+        create(data, size);
     }
 
     base_string substr(size_t beg, size_t end) const{
-        if(beg == end) return base_string();
-        if(end - beg == size_ - 1) return copy();
-        base_string str;
-        str.assign(beg, end);
+        if(beg == end) return base_string(this->alloc());
+        if(end - beg == size()) return copy();
+        base_string str(this->alloc());
+        str.assign(std::next(cbegin(), beg), std::next(cbegin(), end));
         return str;
     }
 
 
     it find(CharT v){
-        CharT* it = choose();
-        for(size_t idx = 0; idx < size_ - 1; ++idx)
-            if(TraitsT::eq(v, it[idx])) return &it[idx];
+        CharT* ptr = choose();
+        const CharT* hit = search::find_char<TraitsT>(ptr, size(), v);
+        if(hit) return it(ptr + (hit - ptr));
         return end();
     }
 
     const_it find(CharT v) const{
-        CharT* it = choose();
-        for(size_t idx = 0; idx < size_ - 1; ++idx)
-            if(TraitsT::eq(v, it[idx])) return &it[idx];
+        const CharT* ptr = choose();
+        const CharT* hit = search::find_char<TraitsT>(ptr, size(), v);
+        if(hit) return const_it(hit);
         return cend();
     }
 
 
     it find(it beg, it end, CharT v){
         if(beg == end) return it();
-        for(auto it = beg; it != end; ++it)
-            if(TraitsT::eq(v, *it)) return it;
-        return end();
+        for(auto cur = beg; cur != end; ++cur)
+            if(TraitsT::eq(v, *cur)) return cur;
+        return this->end();
     }
 
     const_it find(const_it beg, const_it end, CharT v) const{
-        if(beg == end) return it();
-        for(auto it = beg; it != end; it = std::next(it))
-            if(TraitsT::eq(v, *it)) return it;
+        if(beg == end) return const_it();
+        for(auto cur = beg; cur != end; cur = std::next(cur))
+            if(TraitsT::eq(v, *cur)) return cur;
         return cend();
     }
 
     template<typename F>
     it find_if(F pred){
-        CharT* it = choose();
-        for(size_t idx = 0; idx < size_ - 1; ++idx)
-            if(pred(it[idx])) return &it[idx];
+        CharT* ptr = choose();
+        for(size_t idx = 0; idx < size(); ++idx)
+            if(pred(ptr[idx])) return it(&ptr[idx]);
         return end();
     }
 
     template<typename F>
     const_it find_if(F pred) const{
-        CharT* it = choose();
-        for(size_t idx = 0; idx < size_ - 1; ++idx)
-            if(pred(it[idx])) return &it[idx];
+        const CharT* ptr = choose();
+        for(size_t idx = 0; idx < size(); ++idx)
+            if(pred(ptr[idx])) return const_it(&ptr[idx]);
         return cend();
     }
 
     size_t count(CharT v) const{
-        size_t res = 0;
-        CharT* it = choose();
-        for(size_t idx = 0; idx < size_ - 1; ++idx) if(TraitsT::eq(v, it[idx])) res++;
-        return res;
+        return search::count_char<TraitsT>(choose(), size(), v);
+    }
+
+    base_string& replace(size_t pos, size_t len, view_type str){
+        const size_t old = size();
+        if(pos > old) throw std::out_of_range("");
+        if(len > old - pos) len = old - pos;
+        const size_t tail = old - pos - len;
+        const size_t n = old - len + str.size() + 1;
+        if(n == 1){
+            release();
+            return *this;
+        }
+        CharT* ptr = choose();
+        if(fits(n) && !search::overlaps(ptr, old, str.data(), str.size())){
+            TraitsT::move(ptr + pos + str.size(), ptr + pos + len, tail);
+            TraitsT::copy(ptr + pos, str.data(), str.size());
+            ptr[n - 1] = CharT();
+            size_ = n;
+            return *this;
+        }
+        rebuild(n, fits(n) ? n : std::max(n, 2 * old), [&](CharT* out){
+            TraitsT::copy(out, ptr, pos);
+            TraitsT::copy(out + pos, str.data(), str.size());
+            TraitsT::copy(out + pos + str.size(), ptr + pos + len, tail);
+        });
+        return *this;
     }
 
-    void push_back(const CharT& el){
-        if(size_ == 0)
-            create(&el, 2, true);
-        return;
-
-        CharT* it = nullptr;
-        if(size_ + 1 < sizeof (Large)){
-            it = &small[0];
-
+    size_t replace_all(view_type needle, view_type str){
+        const size_t old = size();
+        CharT* ptr = choose();
+        const size_t matches = search::count<TraitsT>(ptr, old, needle.data(), needle.size());
+        if(matches == 0) return 0;
+        const size_t n = old - matches * needle.size() + matches * str.size() + 1;
+        if(n == 1){
+            release();
+            return matches;
         }
-        else if(size_ + 1 < large.cap){
-            it = &large.data;
+        if(fits(n) && !search::overlaps(ptr, old, str.data(), str.size())
+                   && !search::overlaps(ptr, old, needle.data(), needle.size())){
+            const CharT* src = ptr;
+            if(n - 1 > old){
+                src = ptr + (n - 1 - old);
+                TraitsT::move(ptr + (n - 1 - old), ptr, old);
+            }
+            search::replace_copy<TraitsT>(ptr, src, old, needle.data(), needle.size(), str.data(), str.size());
+            ptr[n - 1] = CharT();
+            size_ = n;
+            return matches;
         }
-        else{
-            restore();
-            it = large.data;
+        rebuild(n, n, [&](CharT* out){
+            search::replace_copy<TraitsT>(out, ptr, old, needle.data(), needle.size(), str.data(), str.size());
+        });
+        return matches;
+    }
+
+    template<typename F>
+    void resize_and_overwrite(size_t count, F op){
+        const size_t n = count + 1;
+        const size_t keep = std::min(size(), count);
+        if(!fits(n)){
+            if(n < sso){
+                CharT buf[sso] = {};
+                TraitsT::copy(buf, choose(), keep);
+                release();
+                TraitsT::copy(&small[0], buf, sso);
+            }
+            else{
+                MY_STRING_RECORD(heap_spill);
+                const size_t cap = std::max(n, 2 * keep);
+                CharT* data = allocate(cap);
+                TraitsT::copy(data, choose(), keep);
+                if(size_ >= sso) deallocate(large.data, large.cap);
+                large.data = data;
+                large.cap  = cap;
+                size_ = n;
+            }
         }
-        it[size_] = el;
-        it[size_ + 1] = '\0';
-        size_++;
+        const bool heap = size_ >= sso;
+        CharT* ptr = heap ? large.data : &small[0];
+        const size_t res = op(ptr, count);
+        if(heap && res + 1 < sso){
+            CharT buf[sso] = {};
+            TraitsT::copy(buf, ptr, res);
+            deallocate(large.data, large.cap);
+            TraitsT::copy(&small[0], buf, sso);
+            ptr = &small[0];
+        }
+        ptr[res] = CharT();
+        size_ = res + 1;
+    }
+
+    template<typename T>
+    base_string& append_int(T value){
+        static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "append_int formats integers");
+        const size_t old = size();
+        const size_t len = numeric::digits(value);
+        resize_and_overwrite(old + len, [&](CharT* out, size_t n){
+            numeric::format(out + old, len, value);
+            return n;
+        });
+        return *this;
+    }
 
+    base_string& append_double(double value){
+        CharT buf[numeric::max_chars<double>];
+        const size_t len = numeric::format(buf, numeric::max_chars<double>, value);
+        const size_t old = size();
+        resize_and_overwrite(old + len, [&](CharT* out, size_t n){
+            TraitsT::copy(out + old, buf, len);
+            return n;
+        });
+        return *this;
     }
 
-    void push_back(CharT&& el){
-        if(size_ == 0)
-            create(&el, 2, true);
-        return;
+    template<typename T>
+    T to_number() const{
+        return numeric::to_number<T>(choose(), size());
+    }
 
-        CharT* it = nullptr;
-        if(size_ + 1 < sizeof (Large)){
-            it = &small[0];
+    void push_back(const CharT& el){
+        if(size_ == 0){
+            CharT data[2] = {el, CharT()};
+            create(data, 2);
+            return;
+        }
 
+        CharT* ptr = nullptr;
+        if(size_ + 1 < sso){
+            ptr = &small[0];
         }
-        else if(size_ + 1 < large.cap){
-            it = &large.data;
+        else if(size_ >= sso && size_ + 1 <= large.cap){
+            ptr = large.data;
         }
         else{
             restore();
-            it = large.data;
+            ptr = large.data;
         }
-        it[size_] = el;
-        it[size_ + 1] = '\0';
+        ptr[size_ - 1] = el;
+        ptr[size_] = CharT();
         size_++;
     }
 
+    void push_back(CharT&& el){
+        push_back(static_cast<const CharT&>(el));
+    }
+
     void erase(const_it targ){
         if(targ == cend() || targ == const_it()) return;
         if(size_ == 0) return;
@@ -420,5 +627,21 @@ std::basic_ostream<CharU, TraitsU>& operator<<(std::basic_ostream<CharU, TraitsU
 
 namespace my {
 using string = my::base_string<char>;
+
+namespace pmr {
+template<typename CharT,
+         typename TraitsT = std::char_traits<CharT>>
+using base_string = my::base_string<CharT, TraitsT, std::pmr::polymorphic_allocator<CharT>>;
+
+using string = my::pmr::base_string<char>;
+}
+
+namespace pooled {
+template<typename CharT,
+         typename TraitsT = std::char_traits<CharT>>
+using base_string = my::base_string<CharT, TraitsT, my::pool_allocator<CharT>>;
+
+using string = my::pooled::base_string<char>;
+}
 }
 
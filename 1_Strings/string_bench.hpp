@@ -0,0 +1,334 @@
+#pragma once
+
+#include <string.hpp>
+#include <cow_string.hpp>
+#include <utility.hpp>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <memory>
+#include <iostream>
+#include <algorithm>
+#include <type_traits>
+
+namespace my {
+namespace bench {
+
+struct alloc_counter{
+    size_t allocs = 0;
+    size_t bytes  = 0;
+};
+
+inline alloc_counter& counter(){
+    static thread_local alloc_counter c;
+    return c;
+}
+
+template<typename T>
+struct counting_allocator{
+
+    using value_type = T;
+
+    counting_allocator() = default;
+
+    template<typename U>
+    counting_allocator(const counting_allocator<U>&){}
+
+    T* allocate(size_t n){
+        counter().allocs++;
+        counter().bytes += n * sizeof (T);
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n){
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template<typename U>
+    bool operator==(const counting_allocator<U>&) const{
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const counting_allocator<U>&) const{
+        return false;
+    }
+};
+
+using string     = my::base_string<char, std::char_traits<char>, counting_allocator<char>>;
+using cow_string = my::cow_base_string<char, std::char_traits<char>, counting_allocator<char>>;
+using std_string = std::basic_string<char, std::char_traits<char>, counting_allocator<char>>;
+
+template<typename T>
+inline void do_not_optimize(const T& value){
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+}
+
+struct result{
+    std::string name;
+    size_t iterations       = 0;
+    double ns_per_op        = 0;
+    double bytes_per_second = 0;
+    double allocs_per_op    = 0;
+    double bytes_alloc_per_op = 0;
+    double items_per_second = 0;
+    double p50_ns           = 0;
+    double p99_ns           = 0;
+    size_t peak_rss_bytes   = 0;
+};
+
+class runner{
+
+    std::vector<result> results_;
+    std::chrono::nanoseconds min_time_;
+
+public:
+
+    explicit runner(std::chrono::nanoseconds min_time = std::chrono::milliseconds(200)) : min_time_(min_time) {}
+
+    template<typename F>
+    void run(const std::string& name, size_t bytes, F&& op){
+        using clock = std::chrono::steady_clock;
+        size_t iters = 1;
+        while(true){
+            alloc_counter before = counter();
+            auto start = clock::now();
+            for(size_t i = 0; i < iters; ++i) op();
+            auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start);
+            if(elapsed >= min_time_ || iters >= (size_t(1) << 30)){
+                alloc_counter after = counter();
+                result r;
+                r.name               = name;
+                r.iterations         = iters;
+                r.ns_per_op          = double(elapsed.count()) / iters;
+                r.bytes_per_second   = r.ns_per_op > 0 ? bytes * 1e9 / r.ns_per_op : 0;
+                r.allocs_per_op      = double(after.allocs - before.allocs) / iters;
+                r.bytes_alloc_per_op = double(after.bytes - before.bytes) / iters;
+                results_.push_back(r);
+                return;
+            }
+            size_t next = elapsed.count() > 0 ? size_t(iters * 1.4 * min_time_.count() / elapsed.count()) : iters * 10;
+            iters = std::max(iters * 2, std::min(next, iters * 100));
+        }
+    }
+
+    void add(const result& r){
+        results_.push_back(r);
+    }
+
+    const std::vector<result>& results() const{
+        return results_;
+    }
+
+    void write_json(std::ostream& os, const std::string& library) const{
+        std::time_t now = std::time(nullptr);
+        char date[32] = {};
+        std::strftime(date, sizeof (date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+        os << "{\n"
+           << "  \"context\": {\n"
+           << "    \"date\": \"" << date << "\",\n"
+           << "    \"library\": \"" << library << "\",\n"
+           << "    \"num_cpus\": " << std::thread::hardware_concurrency() << "\n"
+           << "  },\n"
+           << "  \"benchmarks\": [\n";
+        for(size_t i = 0; i < results_.size(); ++i){
+            const result& r = results_[i];
+            os << "    {\n"
+               << "      \"name\": \"" << r.name << "\",\n"
+               << "      \"iterations\": " << r.iterations << ",\n"
+               << "      \"real_time\": " << r.ns_per_op << ",\n"
+               << "      \"time_unit\": \"ns\",\n"
+               << "      \"bytes_per_second\": " << r.bytes_per_second << ",\n"
+               << "      \"items_per_second\": " << r.items_per_second << ",\n"
+               << "      \"allocs_per_iter\": " << r.allocs_per_op << ",\n"
+               << "      \"alloc_bytes_per_iter\": " << r.bytes_alloc_per_op;
+            if(r.p50_ns > 0 || r.p99_ns > 0)
+                os << ",\n      \"p50_ns\": " << r.p50_ns << ",\n      \"p99_ns\": " << r.p99_ns;
+            if(r.peak_rss_bytes > 0)
+                os << ",\n      \"peak_rss_bytes\": " << r.peak_rss_bytes;
+            os << "\n    }" << (i + 1 == results_.size() ? "\n" : ",\n");
+        }
+        os << "  ]\n}\n";
+    }
+};
+
+template<typename StringT>
+struct ops;
+
+template<>
+struct ops<string>{
+    using string_type = string;
+    static const char* name(){ return "string"; }
+    static string make(const char* p, size_t n){ return string(p, n); }
+    static void push_back(string& s, char c){ s.push_back(c); }
+    static bool find(const string& s, char c){ return s.find(c) != s.cend(); }
+    static size_t count(const string& s, char c){ return s.count(c); }
+    static string substr(const string& s, size_t beg, size_t end){ return s.substr(beg, end); }
+    static size_t split(const string& s, char c){ return my::split(s, c).size(); }
+    static bool equal(const string& lhs, const string& rhs){ return lhs == rhs; }
+};
+
+template<>
+struct ops<cow_string>{
+    using string_type = cow_string;
+    static const char* name(){ return "cow_string"; }
+    static cow_string make(const char* p, size_t n){ return cow_string(p, n); }
+    static void push_back(cow_string& s, char c){ s.push_back(c); }
+    static cow_string plus(const cow_string& lhs, const cow_string& rhs){ return lhs + rhs; }
+    static bool find(const cow_string& s, char c){ return s.cfind(c) != s.cend(); }
+    static size_t count(const cow_string& s, char c){ return s.count(c); }
+    static cow_string substr(const cow_string& s, size_t beg, size_t end){ return s.substr(beg, end); }
+    static size_t split(const cow_string& s, char c){ return my::split(s, c).size(); }
+    static bool equal(const cow_string& lhs, const cow_string& rhs){ return lhs == rhs; }
+};
+
+template<>
+struct ops<std_string>{
+    using string_type = std_string;
+    static const char* name(){ return "std_string"; }
+    static std_string make(const char* p, size_t n){ return std_string(p, n); }
+    static void push_back(std_string& s, char c){ s.push_back(c); }
+    static std_string plus(const std_string& lhs, const std_string& rhs){ return lhs + rhs; }
+    static bool find(const std_string& s, char c){ return s.find(c) != std_string::npos; }
+    static size_t count(const std_string& s, char c){ return std::count(s.begin(), s.end(), c); }
+    static std_string substr(const std_string& s, size_t beg, size_t end){ return s.substr(beg, end - beg); }
+    static size_t split(const std_string& s, char c){
+        std::vector<std_string> res;
+        res.reserve(count(s, c) + 1);
+        size_t beg = 0;
+        while(true){
+            size_t end = s.find(c, beg);
+            if(end == std_string::npos){
+                res.emplace_back(s, beg);
+                break;
+            }
+            res.emplace_back(s, beg, end - beg);
+            beg = end + 1;
+        }
+        return res.size();
+    }
+    static bool equal(const std_string& lhs, const std_string& rhs){ return lhs == rhs; }
+};
+
+template<typename O, typename = void>
+struct has_plus : std::false_type {};
+
+template<typename O>
+struct has_plus<O, std::void_t<decltype(O::plus(std::declval<const typename O::string_type&>(),
+                                                std::declval<const typename O::string_type&>()))>> : std::true_type {};
+
+struct size_class{
+    const char* name;
+    size_t size;
+    bool push_back;
+};
+
+inline const std::vector<size_class>& size_classes(){
+    static const std::vector<size_class> classes = {
+        {"inline",   7,         true},
+        {"sso+1",    16,        true},
+        {"4K",       4096,      true},
+        {"1M",       1 << 20,   false},
+    };
+    return classes;
+}
+
+inline std::vector<char> make_input(size_t n){
+    std::vector<char> data(n + 1, '\0');
+    unsigned state = 0x9e3779b9u;
+    for(size_t i = 0; i < n; ++i){
+        state = state * 1103515245u + 12345u;
+        data[i] = (i % 8 == 7) ? ',' : char('a' + (state >> 16) % 26);
+    }
+    return data;
+}
+
+template<typename StringT>
+void run_suite(runner& r, const size_class& cls){
+    using O = ops<StringT>;
+    const size_t n = cls.size;
+    const std::vector<char> input = make_input(n);
+    const std::string prefix = std::string(O::name()) + "/";
+    const std::string suffix = std::string("/") + cls.name;
+
+    const StringT src  = O::make(input.data(), n);
+    const StringT same = O::make(input.data(), n);
+
+    r.run(prefix + "construct" + suffix, n, [&]{
+        StringT s = O::make(input.data(), n);
+        do_not_optimize(s);
+    });
+
+    r.run(prefix + "copy" + suffix, n, [&]{
+        StringT s(src);
+        do_not_optimize(s);
+    });
+
+    StringT moving = O::make(input.data(), n);
+    r.run(prefix + "move" + suffix, n, [&]{
+        StringT tmp(std::move(moving));
+        moving = std::move(tmp);
+        do_not_optimize(moving);
+    });
+
+    if(cls.push_back){
+        r.run(prefix + "push_back" + suffix, n, [&]{
+            StringT s;
+            for(size_t i = 0; i < n; ++i) O::push_back(s, input[i]);
+            do_not_optimize(s);
+        });
+    }
+
+    if constexpr (has_plus<O>::value){
+        r.run(prefix + "plus" + suffix, 2 * n, [&]{
+            StringT s = O::plus(src, same);
+            do_not_optimize(s);
+        });
+    }
+
+    r.run(prefix + "find" + suffix, n, [&]{
+        bool found = O::find(src, 'Z');
+        do_not_optimize(found);
+    });
+
+    r.run(prefix + "count" + suffix, n, [&]{
+        size_t res = O::count(src, ',');
+        do_not_optimize(res);
+    });
+
+    r.run(prefix + "substr" + suffix, n / 2, [&]{
+        StringT s = O::substr(src, n / 4, n / 4 + n / 2);
+        do_not_optimize(s);
+    });
+
+    r.run(prefix + "split" + suffix, n, [&]{
+        size_t res = O::split(src, ',');
+        do_not_optimize(res);
+    });
+
+    r.run(prefix + "equal" + suffix, n, [&]{
+        bool res = O::equal(src, same);
+        do_not_optimize(res);
+    });
+}
+
+}
+}
+
+void Bench_strings(std::ostream& os = std::cout,
+                   std::chrono::nanoseconds min_time = std::chrono::milliseconds(200)){
+    my::bench::runner r(min_time);
+    for(const auto& cls : my::bench::size_classes()){
+        my::bench::run_suite<my::bench::std_string>(r, cls);
+        my::bench::run_suite<my::bench::string>(r, cls);
+        my::bench::run_suite<my::bench::cow_string>(r, cls);
+    }
+    r.write_json(os, "my::string,my::cow_string,std::string");
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <vector>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <cow_string.hpp>
+#include <search.hpp>
+#include <split_arena.hpp>
+#include <string_parts.hpp>
+
+namespace my {
+
+template<typename CharT,
+         typename TraitsT = std::char_traits<CharT>,
+         typename Allocator = std::allocator<CharT>>
+class base_string_column{
+
+    using string_type  = cow_base_string<CharT, TraitsT, Allocator>;
+    using view_type    = std::basic_string_view<CharT, TraitsT>;
+    using offset_alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<size_t>;
+
+    std::vector<CharT, Allocator> chars_;
+    std::vector<size_t, offset_alloc> offsets_;
+
+public:
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    explicit base_string_column(const Allocator& alloc = Allocator())
+        : chars_(alloc), offsets_(1, 0, offset_alloc(alloc)) {}
+
+    template<typename InputIt>
+    base_string_column(InputIt beg, InputIt end, const Allocator& alloc = Allocator()) : base_string_column(alloc){
+        append(beg, end);
+    }
+
+    explicit base_string_column(const split_arena<CharT, TraitsT, Allocator>& tokens)
+        : base_string_column(tokens.buffer().get_allocator()){
+        append(tokens);
+    }
+
+    size_t size() const{
+        return offsets_.size() - 1;
+    }
+
+    bool empty() const{
+        return size() == 0;
+    }
+
+    size_t bytes() const{
+        return chars_.size() * sizeof (CharT);
+    }
+
+    void reserve(size_t entries, size_t chars){
+        offsets_.reserve(entries + 1);
+        chars_.reserve(chars);
+    }
+
+    void clear(){
+        chars_.clear();
+        offsets_.resize(1);
+    }
+
+    void append(const CharT* data, size_t n){
+        chars_.insert(chars_.end(), data, data + n);
+        offsets_.push_back(chars_.size());
+    }
+
+    void append(view_type str){
+        append(str.data(), str.size());
+    }
+
+    template<typename StringT,
+             std::enable_if_t<!std::is_convertible_v<const StringT&, view_type>, int> = 0>
+    void append(const StringT& str){
+        append(str.c_str(), str.size());
+    }
+
+    template<typename InputIt>
+    void append(InputIt beg, InputIt end){
+        using category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>){
+            size_t entries = 0, chars = 0;
+            for(auto cur = beg; cur != end; ++cur){
+                entries++;
+                chars += as_view<view_type>(*cur).size();
+            }
+            reserve(size() + entries, chars_.size() + chars);
+        }
+        for(; beg != end; ++beg) append(as_view<view_type>(*beg));
+    }
+
+    void append(const split_arena<CharT, TraitsT, Allocator>& tokens){
+        reserve(size() + tokens.size(), chars_.size() + tokens.buffer().size() + 1 - tokens.size());
+        for(size_t i = 0; i < tokens.size(); ++i) append(tokens[i]);
+    }
+
+    size_t length(size_t idx) const{
+        return offsets_[idx + 1] - offsets_[idx];
+    }
+
+    view_type operator[](size_t idx) const{
+        return view_type(chars_.data() + offsets_[idx], length(idx));
+    }
+
+    view_type view(size_t idx) const{
+        return (*this)[idx];
+    }
+
+    string_type string(size_t idx) const{
+        string_type res(chars_.get_allocator());
+        CharT* data = res.create_exact(length(idx) + 1);
+        TraitsT::copy(data, chars_.data() + offsets_[idx], length(idx));
+        data[length(idx)] = CharT();
+        return res;
+    }
+
+    const CharT* data() const{
+        return chars_.data();
+    }
+
+    const std::vector<size_t, offset_alloc>& offsets() const{
+        return offsets_;
+    }
+
+    std::vector<size_t> find(CharT v) const{
+        std::vector<size_t> res(size(), npos);
+        const CharT* base = chars_.data();
+        const size_t total = chars_.size();
+        size_t idx = 0;
+        size_t pos = 0;
+        while(pos < total){
+            const CharT* hit = search::find_char<TraitsT>(base + pos, total - pos, v);
+            if(!hit) break;
+            pos = hit - base;
+            while(offsets_[idx + 1] <= pos) idx++;
+            res[idx] = pos - offsets_[idx];
+            pos = offsets_[idx + 1];
+        }
+        return res;
+    }
+
+    std::vector<size_t> find(view_type needle) const{
+        std::vector<size_t> res(size(), npos);
+        for(size_t idx = 0; idx < size(); ++idx){
+            size_t pos = (*this)[idx].find(needle);
+            if(pos != view_type::npos) res[idx] = pos;
+        }
+        return res;
+    }
+
+    std::vector<size_t> count(CharT v) const{
+        std::vector<size_t> res(size(), 0);
+        const CharT* base = chars_.data();
+        for(size_t idx = 0; idx < size(); ++idx) res[idx] = search::count_char<TraitsT>(base + offsets_[idx], length(idx), v);
+        return res;
+    }
+
+    size_t count(view_type str) const{
+        size_t res = 0;
+        for(size_t idx = 0; idx < size(); ++idx)
+            if(length(idx) == str.size() && search::compare<TraitsT>(chars_.data() + offsets_[idx], str.data(), str.size()) == 0) res++;
+        return res;
+    }
+
+    std::vector<int> compare(view_type str) const{
+        std::vector<int> res(size());
+        for(size_t idx = 0; idx < size(); ++idx) res[idx] = (*this)[idx].compare(str);
+        return res;
+    }
+
+    template<typename AllocatorU>
+    std::vector<int> compare(const base_string_column<CharT, TraitsT, AllocatorU>& other) const{
+        if(other.size() != size()) throw std::invalid_argument("Column sizes differ");
+        std::vector<int> res(size());
+        for(size_t idx = 0; idx < size(); ++idx) res[idx] = (*this)[idx].compare(other[idx]);
+        return res;
+    }
+};
+
+using string_column = my::base_string_column<char>;
+
+namespace pmr {
+template<typename CharT,
+         typename TraitsT = std::char_traits<CharT>>
+using base_string_column = my::base_string_column<CharT, TraitsT, std::pmr::polymorphic_allocator<CharT>>;
+
+using string_column = my::pmr::base_string_column<char>;
+}
+
+}
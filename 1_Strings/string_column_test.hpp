@@ -0,0 +1,72 @@
+#pragma once
+#include <string.hpp>
+#include <cow_string.hpp>
+#include <string_column.hpp>
+#include <utility.hpp>
+#include <cassert>
+#include <iostream>
+
+void Test_column_append(){
+    my::string_column col;
+    col.append("alpha");
+    col.append(my::string("beta"));
+    col.append(my::cow_string("gamma"));
+    col.append(my::cow_string());
+    assert(col.size() == 4);
+    assert(col.bytes() == 14);
+    assert(col[0] == "alpha");
+    assert(col[1] == "beta");
+    assert(col[2] == "gamma");
+    assert(col[3].empty());
+
+    my::cow_string gamma = col.string(2);
+    assert(gamma == "gamma");
+    assert(gamma.references() == 1);
+}
+
+void Test_column_split(){
+    my::cow_string line("a,bb,,ccc,bb");
+    my::string_column from_arena(my::split_into_arena(line, ','));
+    auto tokens = my::split(line, ',');
+    my::string_column from_vector(tokens.begin(), tokens.end());
+    assert(from_arena.size() == 5);
+    assert(from_vector.size() == 5);
+    for(auto r : from_arena.compare(from_vector)) assert(r == 0);
+    assert(from_arena[3] == "ccc");
+}
+
+void Test_column_kernels(){
+    const char* words[] = {"apple", "", "banana", "cherry", "banana", "kiwi"};
+    my::string_column col(std::begin(words), std::end(words));
+
+    auto first_a = col.find('a');
+    assert(first_a[0] == 0);
+    assert(first_a[1] == my::string_column::npos);
+    assert(first_a[2] == 1);
+    assert(first_a[3] == my::string_column::npos);
+    assert(first_a[5] == my::string_column::npos);
+
+    auto nan = col.find(std::string_view("nan"));
+    assert(nan[2] == 2);
+    assert(nan[0] == my::string_column::npos);
+
+    auto as = col.count('a');
+    assert(as[2] == 3);
+    assert(as[0] == 1);
+    assert(as[1] == 0);
+
+    assert(col.count(std::string_view("banana")) == 2);
+    assert(col.count(std::string_view("")) == 1);
+
+    auto cmp = col.compare(std::string_view("banana"));
+    assert(cmp[0] < 0);
+    assert(cmp[2] == 0);
+    assert(cmp[3] > 0);
+}
+
+void Test_string_column(){
+    Test_column_append();
+    Test_column_split();
+    Test_column_kernels();
+    std::cout << "String column tests passed\n";
+}
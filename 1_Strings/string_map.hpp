@@ -0,0 +1,443 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+#include <allocator.hpp>
+#include <search.hpp>
+#include <cow_string.hpp>
+#include <string_parts.hpp>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace my {
+
+template<typename CharT>
+struct string_hash{
+    size_t operator()(std::basic_string_view<CharT> str) const{
+        return std::hash<std::basic_string_view<CharT>>()(str);
+    }
+};
+
+template<typename StringT,
+         typename Value,
+         typename Hash = string_hash<typename string_parts<StringT>::char_type>>
+class string_map : private allocator_holder<typename string_parts<StringT>::allocator_type>{
+
+    using parts       = string_parts<StringT>;
+    using char_type   = typename parts::char_type;
+    using traits_type = typename parts::traits_type;
+    using view_type   = typename parts::view_type;
+    using holder      = allocator_holder<typename parts::allocator_type>;
+
+public:
+
+    using key_type       = StringT;
+    using mapped_type    = Value;
+    using allocator_type = typename parts::allocator_type;
+
+private:
+
+    template<typename T>
+    using rebind = typename std::allocator_traits<allocator_type>::template rebind_alloc<T>;
+
+    static constexpr size_t  group   = 16;
+    static constexpr int8_t  vacant  = -128;
+    static constexpr int8_t  deleted = -2;
+
+    struct meta{
+        size_t hash   = 0;
+        size_t length = 0;
+    };
+
+    struct slot{
+        union{
+            StringT key;
+        };
+        union{
+            Value value;
+        };
+
+        slot(){}
+        ~slot(){}
+    };
+
+    std::vector<int8_t, rebind<int8_t>>     ctrl_;
+    std::vector<meta, rebind<meta>>         meta_;
+    std::vector<slot, rebind<slot>>         slots_;
+    size_t size_   = 0;
+    size_t growth_ = 0;
+    Hash hash_;
+
+    static int8_t fingerprint(size_t hash){
+        return static_cast<int8_t>(hash & 0x7F);
+    }
+
+    size_t groups() const{
+        return ctrl_.size() / group;
+    }
+
+    static uint32_t match(const int8_t* ctrl, int8_t tag){
+#if defined(__SSE2__)
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(tag))));
+#else
+        uint32_t mask = 0;
+        for(size_t i = 0; i < group; ++i) mask |= uint32_t(ctrl[i] == tag) << i;
+        return mask;
+#endif
+    }
+
+    static uint32_t match_free(const int8_t* ctrl){
+#if defined(__SSE2__)
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+        return static_cast<uint32_t>(_mm_movemask_epi8(block));
+#else
+        uint32_t mask = 0;
+        for(size_t i = 0; i < group; ++i) mask |= uint32_t(ctrl[i] < 0) << i;
+        return mask;
+#endif
+    }
+
+    template<typename Key>
+    static view_type key_view(const Key& key){
+        return as_view<view_type>(key);
+    }
+
+    size_t lookup(view_type key, size_t hash) const{
+        if(ctrl_.empty()) return npos;
+        const int8_t tag = fingerprint(hash);
+        const size_t mask = groups() - 1;
+        size_t g = (hash >> 7) & mask;
+        for(size_t step = 1; ; ++step){
+            const int8_t* ctrl = ctrl_.data() + g * group;
+            for(uint32_t hits = match(ctrl, tag); hits; hits &= hits - 1){
+                const size_t slot = g * group + __builtin_ctz(hits);
+                const meta& m = meta_[slot];
+                if(m.hash == hash && m.length == key.size() &&
+                   (key.empty() || search::compare<traits_type>(slots_[slot].key.c_str(), key.data(), key.size()) == 0)) return slot;
+            }
+            if(match(ctrl, vacant)) return npos;
+            g = (g + step) & mask;
+        }
+    }
+
+    size_t free_slot(size_t hash) const{
+        const size_t mask = groups() - 1;
+        size_t g = (hash >> 7) & mask;
+        for(size_t step = 1; ; ++step){
+            uint32_t hits = match_free(ctrl_.data() + g * group);
+            if(hits) return g * group + __builtin_ctz(hits);
+            g = (g + step) & mask;
+        }
+    }
+
+    void destroy(slot& s){
+        s.key.~StringT();
+        s.value.~Value();
+    }
+
+    void destroy_all(){
+        for(size_t i = 0; i < ctrl_.size(); ++i)
+            if(ctrl_[i] >= 0) destroy(slots_[i]);
+    }
+
+    void rehash(size_t count){
+        std::vector<int8_t, rebind<int8_t>> ctrl(count, vacant, rebind<int8_t>(this->alloc()));
+        std::vector<meta, rebind<meta>>     metas(count, meta(), rebind<meta>(this->alloc()));
+        std::vector<slot, rebind<slot>>     slots(count, rebind<slot>(this->alloc()));
+        ctrl_.swap(ctrl);
+        meta_.swap(metas);
+        slots_.swap(slots);
+        growth_ = count - count / 8 - size_;
+        for(size_t i = 0; i < ctrl.size(); ++i){
+            if(ctrl[i] < 0) continue;
+            const size_t idx = free_slot(metas[i].hash);
+            ctrl_[idx] = ctrl[i];
+            meta_[idx] = metas[i];
+            ::new (static_cast<void*>(&slots_[idx].key)) StringT(std::move(slots[i].key));
+            ::new (static_cast<void*>(&slots_[idx].value)) Value(std::move(slots[i].value));
+            destroy(slots[i]);
+        }
+    }
+
+    void grow(){
+        size_t slots = group;
+        while(slots - slots / 8 < 2 * (size_ + 1)) slots *= 2;
+        rehash(slots);
+    }
+
+    template<typename KeyT, typename... Args>
+    std::pair<size_t, bool> insert_slot(view_type key, KeyT&& make_key, Args&&... args){
+        const size_t hash = hash_(std::basic_string_view<char_type>(key.data(), key.size()));
+        size_t slot = lookup(key, hash);
+        if(slot != npos) return {slot, false};
+        if(growth_ == 0) grow();
+        slot = free_slot(hash);
+        auto& s = slots_[slot];
+        ::new (static_cast<void*>(&s.key)) StringT(make_key());
+        try{
+            ::new (static_cast<void*>(&s.value)) Value(std::forward<Args>(args)...);
+        }
+        catch(...){
+            s.key.~StringT();
+            throw;
+        }
+        if(ctrl_[slot] == vacant) growth_--;
+        meta_[slot]   = meta{hash, key.size()};
+        ctrl_[slot]   = fingerprint(hash);
+        size_++;
+        return {slot, true};
+    }
+
+public:
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    struct reference{
+        const StringT& first;
+        Value& second;
+    };
+
+    struct const_reference{
+        const StringT& first;
+        const Value& second;
+    };
+
+    template<bool Const>
+    class basic_iterator{
+
+        using map_type = std::conditional_t<Const, const string_map, string_map>;
+        using ref_type = std::conditional_t<Const, const_reference, reference>;
+
+        map_type* map_ = nullptr;
+        size_t slot_ = 0;
+
+        void skip(){
+            while(slot_ < map_->ctrl_.size() && map_->ctrl_[slot_] < 0) slot_++;
+        }
+
+        friend class string_map;
+
+    public:
+
+        struct arrow{
+            ref_type ref;
+            const ref_type* operator->() const{
+                return &ref;
+            }
+        };
+
+        basic_iterator() = default;
+
+        basic_iterator(map_type* map, size_t slot) : map_(map), slot_(slot){
+            skip();
+        }
+
+        ref_type operator*() const{
+            return ref_type{map_->slots_[slot_].key, map_->slots_[slot_].value};
+        }
+
+        arrow operator->() const{
+            return arrow{**this};
+        }
+
+        basic_iterator& operator++(){
+            slot_++;
+            skip();
+            return *this;
+        }
+
+        bool operator==(const basic_iterator& other) const{
+            return slot_ == other.slot_;
+        }
+
+        bool operator!=(const basic_iterator& other) const{
+            return slot_ != other.slot_;
+        }
+    };
+
+    using iterator       = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    explicit string_map(const allocator_type& alloc = allocator_type())
+        : holder(alloc),
+          ctrl_(rebind<int8_t>(alloc)), meta_(rebind<meta>(alloc)), slots_(rebind<slot>(alloc)) {}
+
+    explicit string_map(size_t capacity, const allocator_type& alloc = allocator_type()) : string_map(alloc){
+        reserve(capacity);
+    }
+
+    string_map(const string_map& other) : string_map(other.get_allocator()){
+        hash_ = other.hash_;
+        reserve(other.size());
+        for(const auto& [key, value] : other) try_emplace(key, value);
+    }
+
+    string_map(string_map&& other) noexcept
+        : holder(other.get_allocator()),
+          ctrl_(std::move(other.ctrl_)), meta_(std::move(other.meta_)), slots_(std::move(other.slots_)),
+          size_(other.size_), growth_(other.growth_), hash_(std::move(other.hash_)){
+        other.ctrl_.clear();
+        other.size_   = 0;
+        other.growth_ = 0;
+    }
+
+    string_map& operator=(string_map other) noexcept{
+        swap(other);
+        return *this;
+    }
+
+    ~string_map(){
+        destroy_all();
+    }
+
+    void swap(string_map& other) noexcept{
+        using std::swap;
+        swap(this->alloc(), other.alloc());
+        ctrl_.swap(other.ctrl_);
+        meta_.swap(other.meta_);
+        slots_.swap(other.slots_);
+        swap(size_, other.size_);
+        swap(growth_, other.growth_);
+        swap(hash_, other.hash_);
+    }
+
+    size_t size() const{
+        return size_;
+    }
+
+    bool empty() const{
+        return size_ == 0;
+    }
+
+    size_t capacity() const{
+        return ctrl_.size();
+    }
+
+    allocator_type get_allocator() const{
+        return this->alloc();
+    }
+
+    void reserve(size_t n){
+        size_t slots = group;
+        while(slots - slots / 8 < n) slots *= 2;
+        if(slots > ctrl_.size()) rehash(slots);
+    }
+
+    void clear(){
+        destroy_all();
+        std::vector<int8_t, rebind<int8_t>>(rebind<int8_t>(this->alloc())).swap(ctrl_);
+        std::vector<meta, rebind<meta>>(rebind<meta>(this->alloc())).swap(meta_);
+        std::vector<slot, rebind<slot>>(rebind<slot>(this->alloc())).swap(slots_);
+        size_ = 0;
+        growth_ = 0;
+    }
+
+    iterator begin(){
+        return iterator(this, 0);
+    }
+
+    iterator end(){
+        return iterator(this, ctrl_.size());
+    }
+
+    const_iterator begin() const{
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const{
+        return const_iterator(this, ctrl_.size());
+    }
+
+    template<typename Key>
+    iterator find(const Key& key){
+        view_type k = key_view(key);
+        size_t slot = lookup(k, hash_(std::basic_string_view<char_type>(k.data(), k.size())));
+        return slot == npos ? end() : iterator(this, slot);
+    }
+
+    template<typename Key>
+    const_iterator find(const Key& key) const{
+        view_type k = key_view(key);
+        size_t slot = lookup(k, hash_(std::basic_string_view<char_type>(k.data(), k.size())));
+        return slot == npos ? end() : const_iterator(this, slot);
+    }
+
+    template<typename Key>
+    bool contains(const Key& key) const{
+        return find(key) != end();
+    }
+
+    template<typename Key>
+    size_t count(const Key& key) const{
+        return contains(key) ? 1 : 0;
+    }
+
+    template<typename Key>
+    Value& at(const Key& key){
+        iterator it = find(key);
+        if(it == end()) throw std::out_of_range("string_map::at");
+        return slots_[it.slot_].value;
+    }
+
+    template<typename Key>
+    const Value& at(const Key& key) const{
+        const_iterator it = find(key);
+        if(it == end()) throw std::out_of_range("string_map::at");
+        return slots_[it.slot_].value;
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(StringT&& key, Args&&... args){
+        view_type k = key_view(key);
+        auto res = insert_slot(k, [&]{ return std::move(key); }, std::forward<Args>(args)...);
+        return {iterator(this, res.first), res.second};
+    }
+
+    template<typename Key, typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args){
+        view_type k = key_view(key);
+        auto res = insert_slot(k, [&]{
+            if constexpr (std::is_same_v<Key, StringT>) return key;
+            else                                       return StringT(k.data(), k.size(), this->alloc());
+        }, std::forward<Args>(args)...);
+        return {iterator(this, res.first), res.second};
+    }
+
+    template<typename Key>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, Value value){
+        auto res = try_emplace(key);
+        slots_[res.first.slot_].value = std::move(value);
+        return res;
+    }
+
+    template<typename Key>
+    Value& operator[](const Key& key){
+        return slots_[try_emplace(key).first.slot_].value;
+    }
+
+    template<typename Key>
+    size_t erase(const Key& key){
+        view_type k = key_view(key);
+        size_t slot = lookup(k, hash_(std::basic_string_view<char_type>(k.data(), k.size())));
+        if(slot == npos) return 0;
+        destroy(slots_[slot]);
+        ctrl_[slot] = deleted;
+        meta_[slot] = meta();
+        size_--;
+        return 1;
+    }
+};
+
+template<typename Value>
+using cow_string_map = string_map<cow_string, Value>;
+
+}
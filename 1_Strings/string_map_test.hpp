@@ -0,0 +1,116 @@
+#pragma once
+#include <string.hpp>
+#include <cow_string.hpp>
+#include <string_map.hpp>
+#include <string>
+#include <string_view>
+#include <cassert>
+#include <iostream>
+
+void Test_map_basic(){
+    my::cow_string_map<int> map;
+    assert(map.empty());
+    assert(map.try_emplace("alpha", 1).second);
+    assert(map.try_emplace(my::cow_string("beta"), 2).second);
+    assert(!map.try_emplace("alpha", 3).second);
+    map["gamma"] = 3;
+    map[std::string_view("")] = 0;
+    assert(map.size() == 4);
+
+    assert(map.at("alpha") == 1);
+    assert(map.find(std::string_view("beta"))->second == 2);
+    const char* key = "gamma";
+    assert(map.find(key)->second == 3);
+    assert(map.find(my::cow_string("gamma")) != map.end());
+    assert(map.contains(""));
+    assert(!map.contains("delta"));
+    assert(!map.contains("alph"));
+
+    assert(map.erase("beta") == 1);
+    assert(map.erase("beta") == 0);
+    assert(!map.contains("beta"));
+    assert(map.size() == 3);
+
+    size_t seen = 0;
+    for(auto [k, v] : map){
+        assert(map.at(k) == v);
+        seen++;
+    }
+    assert(seen == 3);
+}
+
+void Test_map_lookup_allocs(){
+    my::cow_string_map<size_t> map;
+    for(size_t i = 0; i < 5000; ++i) map.try_emplace(std::string("key-" + std::to_string(i)), i);
+    assert(map.size() == 5000);
+
+    auto before = my::instrumentation::collect();
+    size_t sum = 0;
+    for(int rep = 0; rep < 10; ++rep) sum += map.at("key-4999") + map.count("missing");
+    auto diff = my::instrumentation::collect() - before;
+    assert(diff[my::instrumentation::event::alloc] == 0);
+    assert(sum == 49990);
+
+    for(size_t i = 0; i < 5000; i += 2) assert(map.erase(std::string("key-" + std::to_string(i))) == 1);
+    for(size_t i = 0; i < 5000; ++i) assert(map.contains(std::string("key-" + std::to_string(i))) == (i % 2 == 1));
+
+    my::cow_string shared("shared-key");
+    map.try_emplace(shared, 7);
+    assert(shared.references() == 2);
+}
+
+void Test_map_string_keys(){
+    my::string_map<my::string, int> map(64);
+    size_t cap = map.capacity();
+    map.insert_or_assign("a key long enough to spill", 1);
+    map.insert_or_assign("a key long enough to spill", 2);
+    assert(map.size() == 1);
+    assert(map.at(std::string_view("a key long enough to spill")) == 2);
+    assert(map.capacity() == cap);
+}
+
+struct map_tracked{
+    static inline int live = 0;
+    int value;
+    explicit map_tracked(int v) : value(v){ live++; }
+    map_tracked(const map_tracked& other) : value(other.value){ live++; }
+    map_tracked(map_tracked&& other) : value(other.value){ live++; }
+    ~map_tracked(){ live--; }
+};
+
+void Test_map_slot_lifetime(){
+    {
+        my::cow_string_map<map_tracked> map;
+        assert(map_tracked::live == 0);
+        for(int i = 0; i < 100; ++i) map.try_emplace(std::string("key-" + std::to_string(i)), i);
+        assert(map_tracked::live == 100);
+        assert(map.at("key-42").value == 42);
+
+        for(int i = 0; i < 100; i += 2) map.erase(std::string("key-" + std::to_string(i)));
+        assert(map_tracked::live == 50);
+
+        my::cow_string_map<map_tracked> copy(map);
+        assert(map_tracked::live == 100);
+        assert(copy.at("key-41").value == 41);
+
+        my::cow_string_map<map_tracked> moved(std::move(copy));
+        assert(map_tracked::live == 100);
+        assert(copy.empty() && !copy.contains("key-41"));
+
+        map = moved;
+        assert(map_tracked::live == 100);
+        map.clear();
+        assert(map_tracked::live == 50);
+        map.try_emplace("again", 1);
+        assert(map_tracked::live == 51);
+    }
+    assert(map_tracked::live == 0);
+}
+
+void Test_string_map(){
+    Test_map_basic();
+    Test_map_lookup_allocs();
+    Test_map_string_keys();
+    Test_map_slot_lifetime();
+    std::cout << "String map tests passed\n";
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string_view>
+#include <type_traits>
+
+namespace my {
+
+template<typename StringT>
+struct string_parts;
+
+template<typename CharT,
+         typename TraitsT,
+         typename Allocator,
+         template<typename, typename, typename >typename StringT>
+struct string_parts<StringT<CharT, TraitsT, Allocator>>{
+    using char_type      = CharT;
+    using traits_type    = TraitsT;
+    using allocator_type = Allocator;
+    using view_type      = std::basic_string_view<CharT, TraitsT>;
+};
+
+template<typename StringT>
+struct string_view_of{
+    using type = typename string_parts<StringT>::view_type;
+};
+
+template<typename CharT,
+         typename TraitsT>
+struct string_view_of<std::basic_string_view<CharT, TraitsT>>{
+    using type = std::basic_string_view<CharT, TraitsT>;
+};
+
+template<typename StringT>
+using string_view_of_t = typename string_view_of<StringT>::type;
+
+template<typename ViewT,
+         typename PartT>
+ViewT as_view(const PartT& part){
+    if constexpr (std::is_convertible_v<const PartT&, ViewT>) return ViewT(part);
+    else                                                      return ViewT(part.c_str(), part.size());
+}
+
+}
@@ -1,7 +1,10 @@
 #pragma once
 #include <string.hpp>
+#include <utility.hpp>
+#include <fixed_string.hpp>
 #include <cassert>
 #include <vector>
+#include <cwchar>
 #include <iostream>
 
 void TestCreateStr(){
@@ -9,7 +12,208 @@ void TestCreateStr(){
     my::string str(mess);
 }
 
+void TestPushBackStr(){
+    my::string str("Message");
+    for(char c : {'+', '+', '+', '+', '+', '+', '+', '+', '+', '+'})
+        str.push_back(c);
+    assert(str.size() == 17);
+    assert(*str.back() == '+');
+    assert(std::strcmp(str.c_str(), "Message++++++++++") == 0);
+}
+
+void TestFindStr(){
+    my::string str("Message 1");
+    assert(str.count('s') == 2);
+    assert(str.find('1') != str.end());
+    assert(str.find('Z') == str.end());
+    auto sub = str.substr(0, 7);
+    assert(sub == my::string("Message"));
+}
+
+void TestInstrumentationStr(){
+    auto before = my::instrumentation::collect();
+    my::string small("short");
+    my::string large("a string that does not fit inline");
+    my::string copy(large);
+    auto diff = my::instrumentation::collect() - before;
+#ifdef MY_STRING_INSTRUMENTATION
+    assert(diff[my::instrumentation::event::sso_hit] == 1);
+    assert(diff[my::instrumentation::event::heap_spill] == 2);
+    assert(diff[my::instrumentation::event::deep_copy] == 1);
+    assert(diff[my::instrumentation::event::alloc] == 2);
+#else
+    assert(diff[my::instrumentation::event::alloc] == 0);
+#endif
+}
+
+void TestPmrStr(){
+    static_assert(sizeof (my::string) == sizeof (size_t) + 2 * sizeof (void*));
+    char buffer[1024];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof (buffer), std::pmr::null_memory_resource());
+    my::pmr::string str("a string that does not fit inline", &arena);
+    my::pmr::string copy(str, &arena);
+    assert(str.get_allocator().resource() == &arena);
+    assert(copy == str);
+    auto parts = my::split(str, ' ');
+    assert(parts.size() == 7);
+    assert(parts[0].get_allocator().resource() == &arena);
+}
+
+void TestReplaceStr(){
+    my::string str("key=value");
+    str.replace(4, 5, "another value");
+    assert(std::string_view(str.c_str(), str.size()) == "key=another value");
+    assert(str.size() == 17);
+    str.replace(0, 3, "k");
+    assert(std::string_view(str.c_str(), str.size()) == "k=another value");
+    str.replace(1, 100, "");
+    assert(std::strcmp(str.c_str(), "k") == 0);
+
+    my::string path("alpha/beta/gamma/delta/epsilon");
+    const char* data = path.c_str();
+    assert(path.replace_all("/", "") == 4);
+    assert(path.c_str() == data);
+    assert(std::strcmp(path.c_str(), "alphabetagammadeltaepsilon") == 0);
+    assert(path.replace_all("alphabetagamma", "") == 1);
+    assert(std::strcmp(path.c_str(), "deltaepsilon") == 0);
+
+    my::string words("one two three four five six");
+    data = words.c_str();
+    assert(words.replace_all(" ", "  ") == 5);
+    assert(words.c_str() == data);
+    assert(std::strcmp(words.c_str(), "one  two  three  four  five  six") == 0);
+    assert(words.replace_all("  ", ", and so on, ") == 5);
+    assert(words.size() == 22 + 5 * 13);
+    assert(words.replace_all("xyz", "") == 0);
+    assert(words.replace_all(words.c_str(), "") == 1);
+    assert(words.size() == 0);
+
+    my::string aaa("aaaa");
+    assert(aaa.replace_all("aa", "b") == 2);
+    assert(std::strcmp(aaa.c_str(), "bb") == 0);
+
+    my::string log;
+    size_t moves = 0;
+    for(int i = 0; i < 1000; ++i){
+        const char* prev = log.c_str();
+        log.replace(log.size(), 0, "line\n");
+        if(log.c_str() != prev) moves++;
+    }
+    assert(log.size() == 5000);
+    assert(moves < 16);
+}
+
+void TestFixedStr(){
+    constexpr my::fixed_string<char, 8> methods[] = {"GET", "POST", "PUT", "DELETE"};
+    static_assert(my::lookup(methods, "PUT") == 2);
+    static_assert(my::lookup(methods, "PATCH") == 4);
+    static_assert(methods[3].size() == 6);
+    static_assert(methods[1].find('S') == 2);
+
+    constexpr my::fixed_string prefix("key");
+    constexpr auto joined = prefix + my::fixed_string("=value");
+    static_assert(joined.size() == 9);
+    static_assert(joined == my::fixed_string("key=value"));
+    static_assert(prefix < joined);
+
+    my::string str(joined.c_str(), joined.size());
+    assert(std::strcmp(str.c_str(), "key=value") == 0);
+}
+
+void TestMoveStr(){
+    static_assert(std::is_nothrow_move_constructible_v<my::string>);
+    static_assert(std::is_nothrow_move_assignable_v<my::string>);
+    static_assert(std::is_nothrow_swappable_v<my::string>);
+
+    my::string large("a string that does not fit inline");
+    const char* data = large.c_str();
+    my::string moved(std::move(large));
+    assert(moved.c_str() == data);
+    assert(large.size() == 0);
+    assert(std::strcmp(large.c_str(), "") == 0);
+
+    my::string fresh;
+    assert(std::strcmp(fresh.c_str(), "") == 0);
+
+    my::string target("another heap string, also long");
+    target = std::move(moved);
+    assert(target.c_str() == data);
+    assert(moved.size() == 0);
+    assert(std::strcmp(moved.c_str(), "") == 0);
+
+    my::string small("tiny");
+    swap(small, target);
+    assert(small.c_str() == data);
+    assert(std::strcmp(target.c_str(), "tiny") == 0);
+
+    my::string reuse("a fairly long destination buffer to overwrite");
+    data = reuse.c_str();
+    reuse = small;
+    assert(reuse.c_str() == data);
+    assert(reuse == small);
+
+    std::vector<my::string> strings;
+    for(int i = 0; i < 1000; ++i) strings.emplace_back("a string that does not fit inline");
+    auto before = my::instrumentation::collect();
+    strings.reserve(strings.capacity() * 4);
+    auto diff = my::instrumentation::collect() - before;
+    assert(diff[my::instrumentation::event::alloc] == 0);
+    assert(std::strcmp(strings[999].c_str(), "a string that does not fit inline") == 0);
+}
+
+void TestWideStr(){
+    static_assert(sizeof (my::base_string<char16_t>) == sizeof (my::string));
+    static_assert(sizeof (my::base_string<char32_t>) == sizeof (my::string));
+
+    my::base_string<char16_t> u16(u"a UTF-16 string that spills");
+    assert(u16.size() == 27);
+    assert(u16.count(u't') == 3);
+    assert(*u16.find(u'g') == u'g');
+    assert(u16.find(u'g') == std::next(u16.begin(), 14));
+    assert(u16.find(u'Z') == u16.end());
+    assert(u16 == my::base_string<char16_t>(u"a UTF-16 string that spills"));
+    assert(!(u16 == my::base_string<char16_t>(u"a UTF-16 string that spilLs")));
+
+    my::base_string<char32_t> u32(U"ab");
+    const char32_t* inline_data = u32.c_str();
+    u32.push_back(U'c');
+    u32.push_back(U'd');
+    assert(u32.c_str() != inline_data);
+    assert(std::char_traits<char32_t>::compare(u32.c_str(), U"abcd", 5) == 0);
+    assert(u32.replace_all(U"b", U"\U0001F600\U0001F600") == 1);
+    assert(u32 == my::base_string<char32_t>(U"a\U0001F600\U0001F600cd"));
+
+    const wchar_t* text = L"wide characters through traits";
+    my::base_string<wchar_t> wide(text);
+    assert(wide.size() == std::char_traits<wchar_t>::length(text));
+    assert(wide.count(L'r') == 4);
+    assert(std::wcscmp(wide.substr(0, 4).c_str(), L"wide") == 0);
+}
+
+void TestOverwriteStr(){
+    my::string str("keep");
+    str.resize_and_overwrite(40, [](char* out, size_t n){
+        for(size_t i = 4; i < n; ++i) out[i] = '+';
+        return n;
+    });
+    assert(str.size() == 40);
+    assert(std::strncmp(str.c_str(), "keep++++", 8) == 0);
+
+    str.resize_and_overwrite(40, [](char*, size_t){ return size_t(3); });
+    assert(std::strcmp(str.c_str(), "kee") == 0);
+    str.push_back('p');
+    assert(str == my::string("keep"));
+}
 
 void TestString(){
     TestCreateStr();
+    TestPushBackStr();
+    TestFindStr();
+    TestInstrumentationStr();
+    TestPmrStr();
+    TestReplaceStr();
+    TestFixedStr();
+    TestMoveStr();
+    TestWideStr();
+    TestOverwriteStr();
 }
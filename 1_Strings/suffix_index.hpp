@@ -0,0 +1,305 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <cow_string.hpp>
+#include <search.hpp>
+#include <string_parts.hpp>
+
+namespace my {
+
+namespace suffix {
+
+inline std::vector<int32_t> sa_naive(const std::vector<int32_t>& s){
+    std::vector<int32_t> sa(s.size());
+    for(size_t i = 0; i < sa.size(); ++i) sa[i] = static_cast<int32_t>(i);
+    std::sort(sa.begin(), sa.end(), [&](int32_t l, int32_t r){
+        return std::lexicographical_compare(s.begin() + l, s.end(), s.begin() + r, s.end());
+    });
+    return sa;
+}
+
+inline std::vector<int32_t> sa_is(const std::vector<int32_t>& s, int32_t upper){
+    const int32_t n = static_cast<int32_t>(s.size());
+    if(n < 16) return sa_naive(s);
+
+    std::vector<int32_t> sa(n);
+    std::vector<bool> ls(n, false);
+    for(int32_t i = n - 2; i >= 0; --i)
+        ls[i] = s[i] == s[i + 1] ? ls[i + 1] : s[i] < s[i + 1];
+
+    std::vector<int32_t> sum_l(upper + 1, 0);
+    std::vector<int32_t> sum_s(upper + 1, 0);
+    for(int32_t i = 0; i < n; ++i){
+        if(!ls[i]) sum_s[s[i]]++;
+        else       sum_l[s[i] + 1]++;
+    }
+    for(int32_t i = 0; i <= upper; ++i){
+        sum_s[i] += sum_l[i];
+        if(i < upper) sum_l[i + 1] += sum_s[i];
+    }
+
+    std::vector<int32_t> buf(upper + 1);
+    auto induce = [&](const std::vector<int32_t>& lms){
+        std::fill(sa.begin(), sa.end(), -1);
+        std::copy(sum_s.begin(), sum_s.end(), buf.begin());
+        for(int32_t d : lms) if(d != n) sa[buf[s[d]]++] = d;
+        std::copy(sum_l.begin(), sum_l.end(), buf.begin());
+        sa[buf[s[n - 1]]++] = n - 1;
+        for(int32_t i = 0; i < n; ++i){
+            int32_t v = sa[i];
+            if(v >= 1 && !ls[v - 1]) sa[buf[s[v - 1]]++] = v - 1;
+        }
+        std::copy(sum_l.begin(), sum_l.end(), buf.begin());
+        for(int32_t i = n - 1; i >= 0; --i){
+            int32_t v = sa[i];
+            if(v >= 1 && ls[v - 1]) sa[--buf[s[v - 1] + 1]] = v - 1;
+        }
+    };
+
+    std::vector<int32_t> lms_map(n + 1, -1);
+    std::vector<int32_t> lms;
+    for(int32_t i = 1; i < n; ++i){
+        if(!ls[i - 1] && ls[i]){
+            lms_map[i] = static_cast<int32_t>(lms.size());
+            lms.push_back(i);
+        }
+    }
+    const int32_t m = static_cast<int32_t>(lms.size());
+
+    induce(lms);
+
+    if(m){
+        std::vector<int32_t> sorted;
+        sorted.reserve(m);
+        for(int32_t v : sa) if(lms_map[v] != -1) sorted.push_back(v);
+
+        std::vector<int32_t> rec(m);
+        int32_t rec_upper = 0;
+        rec[lms_map[sorted[0]]] = 0;
+        for(int32_t i = 1; i < m; ++i){
+            int32_t l = sorted[i - 1];
+            int32_t r = sorted[i];
+            int32_t end_l = lms_map[l] + 1 < m ? lms[lms_map[l] + 1] : n;
+            int32_t end_r = lms_map[r] + 1 < m ? lms[lms_map[r] + 1] : n;
+            bool same = end_l - l == end_r - r;
+            if(same){
+                while(l < end_l && s[l] == s[r]){
+                    l++;
+                    r++;
+                }
+                if(l == n || s[l] != s[r]) same = false;
+            }
+            if(!same) rec_upper++;
+            rec[lms_map[sorted[i]]] = rec_upper;
+        }
+
+        std::vector<int32_t> rec_sa = sa_is(rec, rec_upper);
+        for(int32_t i = 0; i < m; ++i) sorted[i] = lms[rec_sa[i]];
+        induce(sorted);
+    }
+    return sa;
+}
+
+}
+
+template<typename CharT,
+         typename TraitsT = std::char_traits<CharT>,
+         typename Allocator = std::allocator<CharT>>
+class base_suffix_index{
+
+    static_assert(sizeof (CharT) == 1, "suffix_index works over a byte alphabet");
+
+    using string_type = cow_base_string<CharT, TraitsT, Allocator>;
+    using view_type   = std::basic_string_view<CharT, TraitsT>;
+
+    static constexpr size_t alphabet = 256;
+    static constexpr size_t block    = 1024;
+
+    string_type text_;
+    size_t rows_    = 0;
+    size_t primary_ = 0;
+    size_t sample_  = 0;
+    std::vector<uint8_t>  bwt_;
+    std::vector<uint32_t> occ_;
+    std::vector<size_t>   c_;
+    std::vector<uint32_t> sa_;
+    std::vector<uint64_t> marks_;
+    std::vector<uint32_t> mark_rank_;
+
+    static uint8_t code(CharT c){
+        return static_cast<uint8_t>(c);
+    }
+
+    size_t rank(uint8_t c, size_t row) const{
+        const size_t b = row / block;
+        size_t res = occ_[b * alphabet + c];
+        res += search::count_char<std::char_traits<char>>(reinterpret_cast<const char*>(bwt_.data()) + b * block,
+                                                          row - b * block, static_cast<char>(c));
+        if(c == 0 && primary_ >= b * block && primary_ < row) res--;
+        return res;
+    }
+
+    size_t lf(size_t row) const{
+        const uint8_t c = bwt_[row];
+        return c_[c] + rank(c, row);
+    }
+
+    bool marked(size_t row) const{
+        return (marks_[row / 64] >> (row % 64)) & 1;
+    }
+
+    size_t mark_index(size_t row) const{
+        const uint64_t below = (uint64_t(1) << (row % 64)) - 1;
+        return mark_rank_[row / 64] + __builtin_popcountll(marks_[row / 64] & below);
+    }
+
+    size_t position(size_t row) const{
+        if(sample_ == 0) return sa_[row];
+        size_t steps = 0;
+        while(!marked(row)){
+            row = lf(row);
+            steps++;
+        }
+        return sa_[mark_index(row)] + steps;
+    }
+
+    std::pair<size_t, size_t> range(view_type pattern) const{
+        size_t lo = 0;
+        size_t hi = rows_;
+        for(size_t i = pattern.size(); i-- > 0 && lo < hi;){
+            const uint8_t c = code(pattern[i]);
+            lo = c_[c] + rank(c, lo);
+            hi = c_[c] + rank(c, hi);
+        }
+        return {lo, hi};
+    }
+
+    void build(const std::vector<int32_t>& sa, size_t threads){
+        const CharT* text = text_.c_str();
+        const size_t n = text_.size();
+        const size_t blocks = rows_ / block + 1;
+        bwt_.assign(rows_, 0);
+        occ_.assign(blocks * alphabet, 0);
+
+        auto fill = [&](size_t first, size_t last){
+            for(size_t b = first; b < last; ++b){
+                uint32_t* counts = b + 1 < blocks ? occ_.data() + (b + 1) * alphabet : nullptr;
+                const size_t end = std::min(rows_, (b + 1) * block);
+                for(size_t row = b * block; row < end; ++row){
+                    const size_t pos = row == 0 ? n : static_cast<size_t>(sa[row - 1]);
+                    if(pos == 0) continue;
+                    const uint8_t c = code(text[pos - 1]);
+                    bwt_[row] = c;
+                    if(counts) counts[c]++;
+                }
+            }
+        };
+        threads = std::max<size_t>(1, std::min(threads, blocks));
+        std::vector<std::thread> pool;
+        const size_t per = (blocks + threads - 1) / threads;
+        for(size_t t = 1; t < threads; ++t)
+            pool.emplace_back(fill, std::min(blocks, t * per), std::min(blocks, (t + 1) * per));
+        fill(0, std::min(blocks, per));
+        for(auto& th : pool) th.join();
+
+        for(size_t b = 1; b < blocks; ++b)
+            for(size_t c = 0; c < alphabet; ++c) occ_[b * alphabet + c] += occ_[(b - 1) * alphabet + c];
+
+        c_.assign(alphabet + 1, 0);
+        for(size_t i = 0; i < n; ++i) c_[code(text[i]) + 1]++;
+        c_[0] = 1;
+        for(size_t c = 1; c <= alphabet; ++c) c_[c] += c_[c - 1];
+
+        for(size_t row = 1; row < rows_; ++row){
+            if(sa[row - 1] == 0){
+                primary_ = row;
+                break;
+            }
+        }
+
+        if(sample_ == 0){
+            sa_.resize(rows_);
+            sa_[0] = static_cast<uint32_t>(n);
+            for(size_t row = 1; row < rows_; ++row) sa_[row] = static_cast<uint32_t>(sa[row - 1]);
+            return;
+        }
+        marks_.assign(rows_ / 64 + 1, 0);
+        for(size_t row = 1; row < rows_; ++row)
+            if(static_cast<size_t>(sa[row - 1]) % sample_ == 0) marks_[row / 64] |= uint64_t(1) << (row % 64);
+        mark_rank_.assign(marks_.size(), 0);
+        for(size_t w = 1; w < marks_.size(); ++w)
+            mark_rank_[w] = mark_rank_[w - 1] + __builtin_popcountll(marks_[w - 1]);
+        for(size_t row = 1; row < rows_; ++row)
+            if(marked(row)) sa_.push_back(static_cast<uint32_t>(sa[row - 1]));
+    }
+
+public:
+
+    struct options{
+        size_t sample  = 0;
+        size_t threads = 1;
+    };
+
+    explicit base_suffix_index(const string_type& text, options opt = options())
+        : text_(text), rows_(text.size() + 1), sample_(opt.sample){
+        const size_t n = text_.size();
+        if(n >= static_cast<size_t>(INT32_MAX)) throw std::length_error("suffix_index supports texts below 2 GiB");
+        const CharT* data = text_.c_str();
+        std::vector<int32_t> s(n);
+        for(size_t i = 0; i < n; ++i) s[i] = code(data[i]);
+        build(suffix::sa_is(s, alphabet - 1), opt.threads);
+    }
+
+    const string_type& text() const{
+        return text_;
+    }
+
+    size_t size() const{
+        return text_.size();
+    }
+
+    bool compressed() const{
+        return sample_ != 0;
+    }
+
+    size_t bytes() const{
+        return bwt_.size() + occ_.size() * sizeof (uint32_t) + c_.size() * sizeof (size_t) +
+               sa_.size() * sizeof (uint32_t) + marks_.size() * sizeof (uint64_t) + mark_rank_.size() * sizeof (uint32_t);
+    }
+
+    template<typename StringT>
+    size_t count(const StringT& str) const{
+        view_type pattern = as_view<view_type>(str);
+        if(pattern.empty()) return size() + 1;
+        auto [lo, hi] = range(pattern);
+        return lo < hi ? hi - lo : 0;
+    }
+
+    template<typename StringT>
+    bool contains(const StringT& str) const{
+        return count(str) != 0;
+    }
+
+    template<typename StringT>
+    std::vector<size_t> locate(const StringT& str) const{
+        view_type pattern = as_view<view_type>(str);
+        std::vector<size_t> res;
+        if(pattern.empty()) return res;
+        auto [lo, hi] = range(pattern);
+        if(lo >= hi) return res;
+        res.reserve(hi - lo);
+        for(size_t row = lo; row < hi; ++row) res.push_back(position(row));
+        std::sort(res.begin(), res.end());
+        return res;
+    }
+};
+
+using suffix_index = my::base_suffix_index<char>;
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cow_string.hpp>
+#include <suffix_index.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <random>
+#include <cassert>
+#include <iostream>
+
+std::vector<size_t> naive_locate(std::string_view text, std::string_view pattern){
+    std::vector<size_t> res;
+    for(size_t pos = text.find(pattern); pos != std::string_view::npos; pos = text.find(pattern, pos + 1)) res.push_back(pos);
+    return res;
+}
+
+void Test_suffix_basic(){
+    my::cow_string text("banana");
+    my::suffix_index index(text);
+    assert(text.references() == 2);
+    assert(index.count("ana") == 2);
+    assert(index.count("banana") == 1);
+    assert(index.count("nab") == 0);
+    assert(index.contains(std::string_view("nan")));
+    assert(!index.contains(my::cow_string("bananas")));
+    assert((index.locate("a") == std::vector<size_t>{1, 3, 5}));
+    assert((index.locate("ana") == std::vector<size_t>{1, 3}));
+    assert(index.locate("x").empty());
+
+    text[0] = 'B';
+    assert(index.text() == "banana");
+    assert(index.count("ban") == 1);
+
+    my::suffix_index empty{my::cow_string()};
+    assert(empty.count("a") == 0);
+    assert(empty.locate("a").empty());
+}
+
+void Test_suffix_brute_force(){
+    std::mt19937 gen(7);
+    for(size_t round = 0; round < 20; ++round){
+        std::string text;
+        const size_t n = 1 + gen() % 5000;
+        const char first = round % 2 ? 'a' : '\0';
+        for(size_t i = 0; i < n; ++i) text.push_back(static_cast<char>(first + gen() % (2 + round % 4)));
+        my::cow_string cow(text.data(), text.size());
+        my::suffix_index full(cow);
+        my::suffix_index sampled(cow, {round % 3 ? 8u + round : 1u, 1 + round % 3});
+        assert(sampled.compressed() && !full.compressed());
+        for(size_t q = 0; q < 50; ++q){
+            const size_t pos = gen() % n;
+            const size_t len = 1 + gen() % 8;
+            std::string_view pattern = std::string_view(text).substr(pos, len);
+            if(q % 5 == 0) pattern = "ab\1";
+            auto expected = naive_locate(text, pattern);
+            assert(full.count(pattern) == expected.size());
+            assert(full.locate(pattern) == expected);
+            assert(sampled.locate(pattern) == expected);
+        }
+    }
+}
+
+void Test_suffix_large(){
+    std::string text;
+    for(size_t i = 0; i < 200000; ++i) text += "GET /api/v" + std::to_string(i % 97) + " 200\n";
+    my::cow_string cow(text.data(), text.size());
+    my::suffix_index index(cow, {32, 4});
+    assert(index.count("/v96 ") == naive_locate(text, "/v96 ").size());
+    assert(index.locate("/v42 200") == naive_locate(text, "/v42 200"));
+    assert(index.bytes() < my::suffix_index(cow).bytes() / 2);
+}
+
+void Test_suffix_index(){
+    Test_suffix_basic();
+    Test_suffix_brute_force();
+    Test_suffix_large();
+    std::cout << "Suffix index tests passed\n";
+}
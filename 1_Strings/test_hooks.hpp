@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace my {
+namespace test_hooks {
+
+enum class step : size_t{
+    atomic_borrowed,
+    atomic_publishing
+};
+
+#ifdef MY_STRING_TEST_HOOKS
+
+using step_hook = void (*)(step);
+
+inline std::atomic<step_hook>& hook(){
+    static std::atomic<step_hook> h{nullptr};
+    return h;
+}
+
+inline void reach(step s){
+    if(step_hook h = hook().load(std::memory_order_acquire)) h(s);
+}
+
+#define MY_STRING_STEP(s)    ::my::test_hooks::reach(::my::test_hooks::step::s)
+
+#else
+
+#define MY_STRING_STEP(s)    ((void)0)
+
+#endif
+
+}
+}
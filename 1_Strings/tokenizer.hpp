@@ -0,0 +1,242 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+#include <initializer_list>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+namespace my {
+
+class char_class{
+
+    uint64_t bits_[4] = {};
+    alignas(16) uint8_t lo_[2][16] = {};
+    alignas(16) uint8_t hi_[2][16] = {};
+
+public:
+
+    char_class() = default;
+
+    char_class(std::initializer_list<char> chars){
+        for(char c : chars) add(c);
+    }
+
+    explicit char_class(std::string_view chars){
+        for(char c : chars) add(c);
+    }
+
+    static char_class whitespace(){
+        return char_class{' ', '\t', '\n', '\v', '\f', '\r'};
+    }
+
+    char_class& add(char ch){
+        uint8_t c = static_cast<uint8_t>(ch);
+        bits_[c >> 6] |= uint64_t(1) << (c & 63);
+        uint8_t hi = c >> 4;
+        uint8_t lo = c & 0x0F;
+        lo_[hi >> 3][lo] |= uint8_t(1 << (hi & 7));
+        hi_[hi >> 3][hi]  = uint8_t(1 << (hi & 7));
+        return *this;
+    }
+
+    bool contains(char ch) const{
+        uint8_t c = static_cast<uint8_t>(ch);
+        return (bits_[c >> 6] >> (c & 63)) & 1;
+    }
+
+    uint64_t classify(const char* data, size_t n) const{
+        uint64_t mask = 0;
+        size_t i = 0;
+#if defined(__SSSE3__)
+        const __m128i nibble = _mm_set1_epi8(0x0F);
+        const __m128i zero   = _mm_setzero_si128();
+        const __m128i lo0 = _mm_load_si128(reinterpret_cast<const __m128i*>(lo_[0]));
+        const __m128i lo1 = _mm_load_si128(reinterpret_cast<const __m128i*>(lo_[1]));
+        const __m128i hi0 = _mm_load_si128(reinterpret_cast<const __m128i*>(hi_[0]));
+        const __m128i hi1 = _mm_load_si128(reinterpret_cast<const __m128i*>(hi_[1]));
+        for(; i + 16 <= n; i += 16){
+            __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i lo = _mm_and_si128(v, nibble);
+            __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+            __m128i m  = _mm_or_si128(_mm_and_si128(_mm_shuffle_epi8(lo0, lo), _mm_shuffle_epi8(hi0, hi)),
+                                      _mm_and_si128(_mm_shuffle_epi8(lo1, lo), _mm_shuffle_epi8(hi1, hi)));
+            uint64_t bits = static_cast<uint16_t>(~_mm_movemask_epi8(_mm_cmpeq_epi8(m, zero)));
+            mask |= bits << i;
+        }
+#endif
+        for(; i < n; ++i) mask |= uint64_t(contains(data[i])) << i;
+        return mask;
+    }
+};
+
+namespace simd {
+
+inline uint64_t prefix_xor(uint64_t x){
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+inline size_t trailing_zeros(uint64_t x){
+    return __builtin_ctzll(x);
+}
+
+inline size_t leading_zeros(uint64_t x){
+    return __builtin_clzll(x);
+}
+
+inline uint64_t low_bits(size_t n){
+    return n >= 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1;
+}
+
+}
+
+template<typename CharT,
+         typename TraitsT = std::char_traits<CharT>>
+class tokenizer{
+
+    static_assert(sizeof (CharT) == 1, "tokenizer classifies bytes");
+
+    using view_type = std::basic_string_view<CharT, TraitsT>;
+
+    char_class delims_;
+    char_class quotes_;
+    char_class escapes_;
+    bool skip_empty_ = false;
+    bool quoted_     = false;
+    bool escaped_    = false;
+
+    struct state{
+        uint64_t in_quote = 0;
+        bool     escape   = false;
+    };
+
+    static const char* bytes(const CharT* data){
+        return reinterpret_cast<const char*>(data);
+    }
+
+    uint64_t escaped_bits(uint64_t escapes, state& st) const{
+        uint64_t res = st.escape ? 1 : 0;
+        escapes &= ~res;
+        st.escape = false;
+        while(escapes){
+            size_t bit = simd::trailing_zeros(escapes);
+            escapes &= escapes - 1;
+            if(bit == 63){
+                st.escape = true;
+                break;
+            }
+            res |= uint64_t(1) << (bit + 1);
+            escapes &= ~(uint64_t(1) << (bit + 1));
+        }
+        return res;
+    }
+
+    uint64_t block(const CharT* data, size_t n, state& st) const{
+        uint64_t delims = delims_.classify(bytes(data), n);
+        if(!quoted_ && !escaped_) return delims;
+        uint64_t escaped = escaped_ ? escaped_bits(escapes_.classify(bytes(data), n), st) : 0;
+        delims &= ~escaped;
+        if(quoted_){
+            uint64_t quotes = quotes_.classify(bytes(data), n) & ~escaped;
+            uint64_t inside = simd::prefix_xor(quotes) ^ st.in_quote;
+            st.in_quote = uint64_t(0) - (inside >> 63);
+            delims &= ~inside;
+        }
+        return delims;
+    }
+
+public:
+
+    explicit tokenizer(const char_class& delims, bool skip_empty = false)
+        : delims_(delims), skip_empty_(skip_empty) {}
+
+    tokenizer& quote(CharT q){
+        quotes_.add(static_cast<char>(q));
+        quoted_ = true;
+        return *this;
+    }
+
+    tokenizer& escape(CharT e){
+        escapes_.add(static_cast<char>(e));
+        escaped_ = true;
+        return *this;
+    }
+
+    const char_class& delimiters() const{
+        return delims_;
+    }
+
+    std::vector<uint64_t> boundaries(view_type text) const{
+        std::vector<uint64_t> res((text.size() + 63) / 64);
+        state st;
+        for(size_t i = 0; i < res.size(); ++i){
+            size_t n = std::min<size_t>(64, text.size() - i * 64);
+            res[i] = block(text.data() + i * 64, n, st);
+        }
+        return res;
+    }
+
+    template<typename F>
+    void for_each(view_type text, F&& callback) const{
+        state st;
+        size_t start = 0;
+        for(size_t base = 0; base < text.size(); base += 64){
+            size_t n = std::min<size_t>(64, text.size() - base);
+            for(uint64_t mask = block(text.data() + base, n, st); mask; mask &= mask - 1){
+                size_t pos = base + simd::trailing_zeros(mask);
+                if(!skip_empty_ || pos != start) callback(text.substr(start, pos - start));
+                start = pos + 1;
+            }
+        }
+        if(!skip_empty_ || start != text.size()) callback(text.substr(start));
+    }
+
+    std::vector<view_type> tokens(view_type text) const{
+        std::vector<view_type> res;
+        for_each(text, [&res](view_type token){ res.push_back(token); });
+        return res;
+    }
+};
+
+template<typename CharT,
+         typename TraitsT>
+std::basic_string_view<CharT, TraitsT> trim_left(std::basic_string_view<CharT, TraitsT> text, const char_class& cls){
+    static_assert(sizeof (CharT) == 1, "trim classifies bytes");
+    for(size_t base = 0; base < text.size(); base += 64){
+        size_t n = std::min<size_t>(64, text.size() - base);
+        uint64_t keep = ~cls.classify(reinterpret_cast<const char*>(text.data() + base), n) & simd::low_bits(n);
+        if(keep) return text.substr(base + simd::trailing_zeros(keep));
+    }
+    return text.substr(text.size());
+}
+
+template<typename CharT,
+         typename TraitsT>
+std::basic_string_view<CharT, TraitsT> trim_right(std::basic_string_view<CharT, TraitsT> text, const char_class& cls){
+    static_assert(sizeof (CharT) == 1, "trim classifies bytes");
+    for(size_t end = text.size(); end > 0;){
+        size_t n = std::min<size_t>(64, end);
+        size_t base = end - n;
+        uint64_t keep = ~cls.classify(reinterpret_cast<const char*>(text.data() + base), n) & simd::low_bits(n);
+        if(keep) return text.substr(0, base + 64 - simd::leading_zeros(keep));
+        end = base;
+    }
+    return text.substr(0, 0);
+}
+
+template<typename CharT,
+         typename TraitsT>
+std::basic_string_view<CharT, TraitsT> trim(std::basic_string_view<CharT, TraitsT> text, const char_class& cls){
+    return trim_right(trim_left(text, cls), cls);
+}
+
+}
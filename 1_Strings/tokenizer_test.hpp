@@ -0,0 +1,81 @@
+#pragma once
+#include <string.hpp>
+#include <cow_string.hpp>
+#include <tokenizer.hpp>
+#include <utility.hpp>
+#include <string_view>
+#include <vector>
+#include <cassert>
+#include <iostream>
+
+void Test_char_class(){
+    my::char_class cls{',', ';', '\x80', '\xff'};
+    std::string text;
+    for(int c = 0; c < 256; ++c) text.push_back(static_cast<char>(c));
+    for(size_t base = 0; base < text.size(); base += 64){
+        uint64_t mask = cls.classify(text.data() + base, 64);
+        for(size_t i = 0; i < 64; ++i)
+            assert(((mask >> i) & 1) == cls.contains(text[base + i]));
+    }
+}
+
+void Test_tokenizer_whitespace(){
+    my::tokenizer<char> tok(my::char_class::whitespace(), true);
+    auto words = tok.tokens("  the quick\tbrown\n\nfox  jumps over the lazy dog, again and again and again  ");
+    assert(words.size() == 14);
+    assert(words[0] == "the");
+    assert(words[3] == "fox");
+    assert(words[8] == "dog,");
+    assert(words[13] == "again");
+
+    my::cow_string line("key=value; other = 42 ;last=");
+    auto parts = my::tokenize(line, my::tokenizer<char>(my::char_class{';', '='}));
+    assert(parts.size() == 6);
+    assert(parts[0] == "key");
+    assert(parts[3] == " 42 ");
+    assert(parts[5].size() == 0);
+    assert(my::strip(parts[3]) == "42");
+}
+
+void Test_tokenizer_quotes(){
+    my::tokenizer<char> csv(my::char_class{','});
+    csv.quote('"').escape('\\');
+    std::string_view row = R"(1,"Smith, John","say \"hi, there\"",\,,end)";
+    auto fields = csv.tokens(row);
+    assert(fields.size() == 5);
+    assert(fields[0] == "1");
+    assert(fields[1] == R"("Smith, John")");
+    assert(fields[2] == R"("say \"hi, there\"")");
+    assert(fields[3] == R"(\,)");
+    assert(fields[4] == "end");
+
+    std::string longrow;
+    for(int i = 0; i < 40; ++i) longrow += "\"a,b,c\",";
+    longrow += "tail";
+    auto many = csv.tokens(longrow);
+    assert(many.size() == 41);
+    for(int i = 0; i < 40; ++i) assert(many[i] == "\"a,b,c\"");
+    assert(many[40] == "tail");
+}
+
+void Test_trim(){
+    auto ws = my::char_class::whitespace();
+    std::string padded(100, ' ');
+    padded += "payload";
+    padded += std::string(70, '\t');
+    assert(my::trim(std::string_view(padded), ws) == "payload");
+    assert(my::trim(std::string_view("   "), ws).empty());
+    assert(my::trim_left(std::string_view(" x "), ws) == "x ");
+    assert(my::trim_right(std::string_view(" x "), ws) == " x");
+
+    my::string str("   a string with spaces that does not fit inline   ");
+    assert(my::strip(str) == my::string("a string with spaces that does not fit inline"));
+}
+
+void Test_tokenizer(){
+    Test_char_class();
+    Test_tokenizer_whitespace();
+    Test_tokenizer_quotes();
+    Test_trim();
+    std::cout << "Tokenizer tests passed\n";
+}
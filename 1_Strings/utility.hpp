@@ -1,8 +1,17 @@
 #pragma once
 #include <vector>
+#include <thread>
+#include <iterator>
+#include <type_traits>
+#include <string_view>
+#include <split_arena.hpp>
+#include <tokenizer.hpp>
+#include <string_parts.hpp>
 
 namespace my {
 
+constexpr size_t join_parallel_threshold = size_t(1) << 20;
+
 
 template<typename CharT,
          typename TraitsT,
@@ -11,18 +20,138 @@ template<typename CharT,
 std::vector<StringT<CharT, TraitsT, Allocator>> split(const StringT<CharT, TraitsT, Allocator>& str,
                                                       CharT sep){
     size_t size = str.count(sep) + 1;
-    std::vector<StringT<CharT, TraitsT, Allocator>> res(size);
+    std::vector<StringT<CharT, TraitsT, Allocator>> res;
+    res.reserve(size);
     auto it = str.cbegin();
-    size_t idx = 0;
     while(std::distance(it, str.cend()) > 0){
         const auto end = str.find(it, str.cend(), sep);
-        StringT<CharT, TraitsT, Allocator> sub;
+        StringT<CharT, TraitsT, Allocator> sub(str.get_allocator());
         sub.assign(it, end);
-        res[idx++] = std::move(sub);
+        res.push_back(std::move(sub));
         if(end == str.cend()) break;
         it = std::next(end);
     }
+    while(res.size() < size) res.emplace_back(str.get_allocator());
+    return res;
+}
+
+template<typename CharT,
+         typename TraitsT,
+         typename Allocator,
+         template<typename, typename, typename >typename StringT>
+split_arena<CharT, TraitsT, Allocator> split_into_arena(const StringT<CharT, TraitsT, Allocator>& str,
+                                                        CharT sep){
+    return split_arena<CharT, TraitsT, Allocator>(str.c_str(), str.size(), sep, str.get_allocator());
+}
+
+template<typename CharT,
+         typename TraitsT,
+         typename Allocator,
+         template<typename, typename, typename >typename StringT>
+std::vector<StringT<CharT, TraitsT, Allocator>> tokenize(const StringT<CharT, TraitsT, Allocator>& str,
+                                                         const tokenizer<CharT, TraitsT>& tok){
+    std::vector<StringT<CharT, TraitsT, Allocator>> res;
+    tok.for_each(std::basic_string_view<CharT, TraitsT>(str.c_str(), str.size()),
+                 [&](std::basic_string_view<CharT, TraitsT> token){
+        res.emplace_back(token.data(), token.size(), str.get_allocator());
+    });
+    return res;
+}
+
+template<typename CharT,
+         typename TraitsT,
+         typename Allocator,
+         template<typename, typename, typename >typename StringT>
+StringT<CharT, TraitsT, Allocator> strip(const StringT<CharT, TraitsT, Allocator>& str,
+                                         const char_class& cls = char_class::whitespace()){
+    std::basic_string_view<CharT, TraitsT> text(str.c_str(), str.size());
+    std::basic_string_view<CharT, TraitsT> res = trim(text, cls);
+    return str.substr(res.data() - text.data(), res.data() - text.data() + res.size());
+}
+
+template<typename ViewT,
+         typename InputIt>
+typename ViewT::value_type* join_copy(typename ViewT::value_type* out, InputIt beg, InputIt end, ViewT sep, bool lead){
+    using traits_type = typename ViewT::traits_type;
+    for(; beg != end; ++beg){
+        if(lead){
+            traits_type::copy(out, sep.data(), sep.size());
+            out += sep.size();
+        }
+        ViewT part = as_view<ViewT>(*beg);
+        traits_type::copy(out, part.data(), part.size());
+        out += part.size();
+        lead = true;
+    }
+    return out;
+}
+
+template<typename StringT,
+         typename Range>
+StringT join(const Range& parts,
+             typename string_parts<StringT>::view_type sep,
+             const typename string_parts<StringT>::allocator_type& alloc = typename string_parts<StringT>::allocator_type(),
+             size_t threads = 1){
+    using view_type = typename string_parts<StringT>::view_type;
+    using char_type = typename string_parts<StringT>::char_type;
+    using iterator  = decltype(std::begin(parts));
+
+    struct chunk{
+        iterator beg;
+        size_t   offset;
+    };
+
+    size_t count = 0;
+    size_t total = 0;
+    for(const auto& part : parts){
+        total += as_view<view_type>(part).size();
+        count++;
+    }
+    StringT res(alloc);
+    if(count == 0) return res;
+    total += (count - 1) * sep.size();
+
+    if(threads < 2 || total < join_parallel_threshold || count < threads){
+        res.resize_and_overwrite(total, [&](char_type* out, size_t n){
+            join_copy(out, std::begin(parts), std::end(parts), sep, false);
+            return n;
+        });
+        return res;
+    }
+
+    const size_t per = (count + threads - 1) / threads;
+    std::vector<chunk> chunks;
+    chunks.reserve(threads + 1);
+    size_t idx = 0;
+    size_t offset = 0;
+    for(iterator it = std::begin(parts); it != std::end(parts); ++it, ++idx){
+        if(idx % per == 0) chunks.push_back(chunk{it, offset});
+        offset += as_view<view_type>(*it).size() + sep.size();
+    }
+    chunks.push_back(chunk{std::end(parts), offset});
+
+    res.resize_and_overwrite(total, [&](char_type* out, size_t n){
+        std::vector<std::thread> pool;
+        pool.reserve(chunks.size() - 2);
+        for(size_t i = 1; i + 1 < chunks.size(); ++i)
+            pool.emplace_back([&, i]{
+                join_copy(out + chunks[i].offset - sep.size(), chunks[i].beg, chunks[i + 1].beg, sep, true);
+            });
+        join_copy(out, chunks[0].beg, chunks[1].beg, sep, false);
+        for(auto& th : pool) th.join();
+        return n;
+    });
     return res;
 }
 
+template<typename Range,
+         typename StringT = std::decay_t<decltype(*std::begin(std::declval<const Range&>()))>>
+StringT join(const Range& parts,
+             typename string_parts<StringT>::view_type sep,
+             size_t threads = 1){
+    using allocator_type = typename string_parts<StringT>::allocator_type;
+    allocator_type alloc = std::begin(parts) != std::end(parts) ? std::begin(parts)->get_allocator() : allocator_type();
+    return join<StringT>(parts, sep, alloc, threads);
+}
+
 }
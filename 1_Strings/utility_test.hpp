@@ -0,0 +1,77 @@
+#pragma once
+#include <string.hpp>
+#include <cow_string.hpp>
+#include <utility.hpp>
+#include <cassert>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iostream>
+
+void Test_split_arena(){
+    my::cow_string line("alpha,beta,,gamma");
+    auto tokens = my::split_into_arena(line, ',');
+    assert(tokens.size() == 4);
+    assert(tokens[0] == "alpha");
+    assert(tokens[1] == "beta");
+    assert(tokens[2].empty());
+    assert(tokens[3] == "gamma");
+    assert(std::strcmp(tokens.c_str(3), "gamma") == 0);
+
+    my::cow_string beta = tokens.string(1);
+    assert(beta == "beta");
+    assert(beta.size() == 4);
+    assert(tokens.buffer().references() == 2);
+    beta[0] = 'B';
+    assert(beta == "Beta");
+    assert(tokens[1] == "beta");
+    assert(tokens.buffer().references() == 1);
+
+    my::cow_string gamma = my::split_into_arena(my::string("x;gamma"), ';').string(1);
+    assert(gamma == "gamma");
+}
+
+void Test_join(){
+    my::cow_string line("alpha,beta,,gamma");
+    auto parts = my::split(line, ',');
+    my::cow_string joined = my::join(parts, ",");
+    assert(joined == line);
+    assert(joined.capacity() == line.size() + 1);
+    assert(my::join(parts, " | ") == "alpha | beta |  | gamma");
+
+    std::vector<std::string_view> views = {"usr", "local", "bin"};
+    my::string path = my::join<my::string>(views, "/");
+    assert(path == my::string("usr/local/bin"));
+    assert(my::join<my::string>(std::vector<std::string_view>(), "/").size() == 0);
+    assert(my::join<my::cow_string>(std::vector<std::string_view>{"one"}, ", ") == "one");
+
+    auto before = my::instrumentation::collect();
+    my::string wide = my::join<my::string>(views, " and also ");
+    auto diff = my::instrumentation::collect() - before;
+    assert(std::strcmp(wide.c_str(), "usr and also local and also bin") == 0);
+#ifdef MY_STRING_INSTRUMENTATION
+    assert(diff[my::instrumentation::event::alloc] == 1);
+#endif
+    (void)diff;
+
+    std::vector<my::cow_string> many;
+    std::string expected;
+    for(size_t i = 0; i < 100000; ++i){
+        std::string word = "entry-" + std::to_string(i) + "-payload";
+        many.emplace_back(word.data(), word.size());
+        if(i) expected += ";";
+        expected += word;
+    }
+    my::cow_string serial   = my::join(many, ";");
+    my::cow_string parallel = my::join(many, ";", 4);
+    assert(serial.size() == expected.size());
+    assert(std::string_view(serial.c_str(), serial.size()) == expected);
+    assert(serial.size() >= my::join_parallel_threshold);
+    assert(parallel == serial);
+}
+
+void Test_utility(){
+    Test_split_arena();
+    Test_join();
+    std::cout << "Utility tests passed\n";
+}